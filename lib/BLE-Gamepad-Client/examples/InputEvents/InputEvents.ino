@@ -0,0 +1,27 @@
+#include <Arduino.h>
+#include <BLEGamepadClient.h>
+
+BLEController controller;
+
+void setup(void) {
+  Serial.begin(115200);
+  controller.begin();
+}
+
+void loop() {
+  BLEInputEvent e;
+  while (controller.readInputEvent(e)) {
+    switch (e.kind) {
+      case BLEInputPressed:
+        Serial.printf("button %04x pressed\n", e.button());
+        break;
+      case BLEInputReleased:
+        Serial.printf("button %04x released\n", e.button());
+        break;
+      case BLEInputAxisMoved:
+        Serial.printf("axis %d moved to %.2f\n", e.axis(), e.value());
+        break;
+    }
+  }
+  delay(10);
+}
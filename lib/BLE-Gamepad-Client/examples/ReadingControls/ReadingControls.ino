@@ -14,7 +14,7 @@ void loop() {
     controller.readControls(e);
 
     Serial.printf("lx: %.2f, ly: %.2f, rx: %.2f, ry: %.2f\n",
-      e.leftStickX, e.leftStickY, e.rightStickX, e.rightStickY);
+      e.leftStickX(), e.leftStickY(), e.rightStickX(), e.rightStickY());
   } else {
     Serial.println("controller not connected");
   }
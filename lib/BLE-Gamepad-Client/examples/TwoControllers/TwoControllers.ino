@@ -22,7 +22,7 @@ void loop() {
     controller1.readControls(e);
 
     Serial.printf("controller1 lx: %.2f, ly: %.2f, rx: %.2f, ry: %.2f\n",
-      e.leftStickX, e.leftStickY, e.rightStickX, e.rightStickY);
+      e.leftStickX(), e.leftStickY(), e.rightStickX(), e.rightStickY());
   } else {
     Serial.println("controller1 not connected");
   }
@@ -31,7 +31,7 @@ void loop() {
     controller2.readControls(e);
 
     Serial.printf("controller2 lx: %.2f, ly: %.2f, rx: %.2f, ry: %.2f\n",
-      e.leftStickX, e.leftStickY, e.rightStickX, e.rightStickY);
+      e.leftStickX(), e.leftStickY(), e.rightStickX(), e.rightStickY());
   } else {
     Serial.println("controller2 not connected");
   }
@@ -3,7 +3,7 @@
 
 void onControlsUpdate(BLEControlsEvent& e) {
   Serial.printf("lx: %.2f, ly: %.2f, rx: %.2f, ry: %.2f\n",
-    e.leftStickX, e.leftStickY, e.rightStickX, e.rightStickY);
+    e.leftStickX(), e.leftStickY(), e.rightStickX(), e.rightStickY());
 }
 
 void onConnect(NimBLEAddress address) {
@@ -5,4 +5,7 @@
 struct BLEBaseEvent {
   /// @brief Peer address of the controller that send this event.
   NimBLEAddress controllerAddress{};
+
+  /// @brief `micros()` when the notification carrying this event arrived in the NimBLE host task.
+  uint32_t timeUs{0};
 };
@@ -14,6 +14,8 @@ BLEController::BLEController(const NimBLEAddress address)
       _onDisconnect([](NimBLEAddress) {}),
       _onControlsUpdate([](BLEControlsEvent&) {}),
       _onControlsUpdateIsSet(false),
+      _onInputEvent([](BLEInputEvent&) {}),
+      _onInputEventIsSet(false),
       _onBatteryUpdate([](BLEBatteryEvent&) {}),
       _onBatteryUpdateIsSet(false) {}
 /**
@@ -44,6 +46,9 @@ bool BLEController::begin() {
   if (_onBatteryUpdateIsSet) {
     _pCtrl->getBattery().onUpdate(_onBatteryUpdate);
   }
+  if (_onInputEventIsSet) {
+    _pCtrl->getInputEvents().onEvent(_onInputEvent);
+  }
 
   return true;
 }
@@ -101,11 +106,14 @@ void BLEController::onDisconnect(const OnDisconnect& callback) {
 /**
  * @brief Read the controls state from the connected controller.
  * @param[out] event Reference to the event instance where the data will be written.
+ * @return Sequence number of the state, it changes with every update sent by the controller. 0 if no update was
+ * received yet, `event` is left untouched then.
  */
-void BLEController::readControls(BLEControlsEvent& event) const {
+uint32_t BLEController::readControls(BLEControlsEvent& event) const {
   if (_pCtrl) {
-    _pCtrl->getControls().read(event);
+    return _pCtrl->getControls().read(event);
   }
+  return 0;
 }
 
 /**
@@ -120,14 +128,44 @@ void BLEController::onControlsUpdate(const OnControlsUpdate& callback) {
   }
 }
 
+/**
+ * @brief Take the oldest input event of the connected controller: a button pressed or released, or an axis moved by
+ * more than `CONFIG_BT_BLEGC_AXIS_DEADBAND`. Consecutive moves of an axis are merged while the event waits in the
+ * queue. Do not mix with `onInputEvent`, both consume the same queue.
+ * @param[out] event Reference to the event instance where the data will be written.
+ * @return True if an event was read; false if there are no events.
+ */
+bool BLEController::readInputEvent(BLEInputEvent& event) const {
+  if (_pCtrl) {
+    return _pCtrl->getInputEvents().pop(event);
+  }
+  return false;
+}
+
+/**
+ * @brief Sets the callback to be invoked for each input event of the controller, see `readInputEvent`. Unlike
+ * `onControlsUpdate` it only runs when a button or an axis actually changed.
+ * @param callback Reference to the callback function.
+ */
+void BLEController::onInputEvent(const OnInputEvent& callback) {
+  _onInputEventIsSet = true;
+  _onInputEvent = callback;
+  if (_pCtrl) {
+    _pCtrl->getInputEvents().onEvent(_onInputEvent);
+  }
+}
+
 /**
  * @brief Read the battery state from the connected controller.
  * @param[out] event Reference to the event instance where the data will be written.
+ * @return Sequence number of the state, it changes with every update sent by the controller. 0 if no update was
+ * received yet, `event` is left untouched then.
  */
-void BLEController::readBattery(BLEBatteryEvent& event) const {
+uint32_t BLEController::readBattery(BLEBatteryEvent& event) const {
   if (_pCtrl) {
-    _pCtrl->getBattery().read(event);
+    return _pCtrl->getBattery().read(event);
   }
+  return 0;
 }
 
 /**
@@ -17,9 +17,11 @@ class BLEController {
   NimBLEAddress getAddress() const;
   void onConnect(const OnConnect& callback);
   void onDisconnect(const OnDisconnect& callback);
-  void readControls(BLEControlsEvent& event) const;
+  uint32_t readControls(BLEControlsEvent& event) const;
   void onControlsUpdate(const OnControlsUpdate& callback);
-  void readBattery(BLEBatteryEvent& event) const;
+  bool readInputEvent(BLEInputEvent& event) const;
+  void onInputEvent(const OnInputEvent& callback);
+  uint32_t readBattery(BLEBatteryEvent& event) const;
   void onBatteryUpdate(const OnBatteryUpdate& callback);
   void writeVibrations(const BLEVibrationsCommand& cmd) const;
 
@@ -30,6 +32,8 @@ class BLEController {
   OnDisconnect _onDisconnect;
   OnControlsUpdate _onControlsUpdate;
   bool _onControlsUpdateIsSet;
+  OnInputEvent _onInputEvent;
+  bool _onInputEventIsSet;
   OnBatteryUpdate _onBatteryUpdate;
   bool _onBatteryUpdateIsSet;
 };
@@ -5,13 +5,19 @@
 #include "logger.h"
 #include "utils.h"
 
-BLEControllerInternal::BLEControllerInternal(const NimBLEAddress allowedAddress)
+BLEControllerInternal::BLEControllerInternal(const NimBLEAddress allowedAddress, BLEDispatcher& dispatcher)
     : _initialized(false),
       _address(),
       _allowedAddress(allowedAddress),
       _lastAddress(),
       _onConnect([](NimBLEAddress) {}),
-      _onDisconnect([](NimBLEAddress) {}) {}
+      _onDisconnect([](NimBLEAddress) {}),
+      _controls(dispatcher),
+      _battery(dispatcher),
+      _vibrations(dispatcher),
+      _inputEvents(dispatcher) {
+  _controls.onDecode([this](const BLEControlsEvent& e) { _inputEvents.push(e, e.timeUs); });
+}
 
 bool BLEControllerInternal::init(BLEControllerModel& model) {
   if (_initialized) {
@@ -23,6 +29,7 @@ bool BLEControllerInternal::init(BLEControllerModel& model) {
   }
 
   if (model.controls.isEnabled()) {
+    _inputEvents.reset();
     if (!_controls.init(_address, model.controls)) {
       return false;
     }
@@ -113,3 +120,7 @@ BLEBatterySignal& BLEControllerInternal::getBattery() {
 BLEVibrationsSignal& BLEControllerInternal::getVibrations() {
   return _vibrations;
 }
+
+BLEInputEventQueue& BLEControllerInternal::getInputEvents() {
+  return _inputEvents;
+}
@@ -4,7 +4,9 @@
 #include "BLEBatteryEvent.h"
 #include "BLEControllerModel.h"
 #include "BLEControlsEvent.h"
+#include "BLEDispatcher.h"
 #include "BLEIncomingSignal.h"
+#include "BLEInputEventQueue.h"
 #include "BLEOutgoingSignal.h"
 
 using OnControlsUpdate = std::function<void(BLEControlsEvent& e)>;
@@ -14,7 +16,7 @@ using OnDisconnect = std::function<void(NimBLEAddress a)>;
 
 class BLEControllerInternal {
  public:
-  explicit BLEControllerInternal(NimBLEAddress allowedAddress);
+  BLEControllerInternal(NimBLEAddress allowedAddress, BLEDispatcher& dispatcher);
   ~BLEControllerInternal() = default;
   bool init(BLEControllerModel& model);
   bool deinit(bool disconnected);
@@ -29,6 +31,7 @@ class BLEControllerInternal {
   BLEControlsSignal& getControls();
   BLEBatterySignal& getBattery();
   BLEVibrationsSignal& getVibrations();
+  BLEInputEventQueue& getInputEvents();
 
  private:
   bool _initialized;
@@ -37,7 +40,8 @@ class BLEControllerInternal {
   NimBLEAddress _lastAddress;
   OnConnect _onConnect{};
   OnDisconnect _onDisconnect{};
-  BLEControlsSignal _controls{};
-  BLEBatterySignal _battery{};
-  BLEVibrationsSignal _vibrations{};
+  BLEControlsSignal _controls;
+  BLEBatterySignal _battery;
+  BLEVibrationsSignal _vibrations;
+  BLEInputEventQueue _inputEvents;
 };
@@ -15,10 +15,13 @@ BLEClientStatus::operator std::string() const {
   return "BLEClientStatus address: " + std::string(address) + ", kind: " + kindStr;
 }
 
-BLEControllerRegistry::BLEControllerRegistry(TaskHandle_t& autoScanTask, BLEDeviceMatcher& matcher)
+BLEControllerRegistry::BLEControllerRegistry(TaskHandle_t& autoScanTask,
+                                             BLEDeviceMatcher& matcher,
+                                             BLEDispatcher& dispatcher)
     : _initialized(false),
       _autoScanTask(autoScanTask),
       _matcher(matcher),
+      _dispatcher(dispatcher),
       _clientStatusQueue(nullptr),
       _clientStatusConsumerTask(nullptr),
       _connectionSlots(nullptr),
@@ -107,7 +110,7 @@ BLEControllerInternal* BLEControllerRegistry::createController(NimBLEAddress all
   }
 
   BLEGC_LOGD(LOG_TAG, "Creating a new controller instance, address: %s", std::string(allowedAddress).c_str());
-  _controllers.emplace_back(allowedAddress);
+  _controllers.emplace_back(allowedAddress, _dispatcher);
   auto& ctrl = _controllers.back();
 
   xTaskNotifyGive(_autoScanTask);
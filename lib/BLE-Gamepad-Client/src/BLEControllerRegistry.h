@@ -5,6 +5,7 @@
 
 #include "BLEControllerInternal.h"
 #include "BLEDeviceMatcher.h"
+#include "BLEDispatcher.h"
 
 enum BLEClientStatusMsgKind : uint8_t { BLEClientConnected = 0, BLEClientDisconnected = 1 };
 
@@ -17,7 +18,7 @@ struct BLEClientStatus {
 
 class BLEControllerRegistry {
  public:
-  BLEControllerRegistry(TaskHandle_t& autoScanTask, BLEDeviceMatcher& matcher);
+  BLEControllerRegistry(TaskHandle_t& autoScanTask, BLEDeviceMatcher& matcher, BLEDispatcher& dispatcher);
 
   bool init();
   bool deinit();
@@ -45,6 +46,7 @@ class BLEControllerRegistry {
   bool _initialized;
   TaskHandle_t& _autoScanTask;
   BLEDeviceMatcher& _matcher;
+  BLEDispatcher& _dispatcher;
   QueueHandle_t _clientStatusQueue;
   TaskHandle_t _clientStatusConsumerTask;
   SemaphoreHandle_t _connectionSlots;
@@ -1,8 +1,78 @@
 #pragma once
 
+#include <stdint.h>
 #include "BLEBaseEvent.h"
 
+/// @brief Bits of `BLEControlsEvent::buttons` and `BLEControlsEvent::changedButtons`.
+enum BLEControlsButton : uint16_t {
+  BLEButtonA = 1 << 0,
+  BLEButtonB = 1 << 1,
+  BLEButtonX = 1 << 2,
+  BLEButtonY = 1 << 3,
+  BLEButtonLeftBumper = 1 << 4,
+  BLEButtonRightBumper = 1 << 5,
+  BLEButtonView = 1 << 6,
+  BLEButtonMenu = 1 << 7,
+  BLEButtonXbox = 1 << 8,
+  BLEButtonLeftStick = 1 << 9,
+  BLEButtonRightStick = 1 << 10,
+  BLEButtonShare = 1 << 11,
+  BLEButtonDpadUp = 1 << 12,
+  BLEButtonDpadRight = 1 << 13,
+  BLEButtonDpadDown = 1 << 14,
+  BLEButtonDpadLeft = 1 << 15,
+};
+
+/**
+ * @brief State of the controls, stored in the packed form the decoder produces: raw stick and trigger values and a
+ * bitmask of the buttons. The float and bool accessors convert on demand, so copying an event moves the 16 bytes below
+ * and the base event.
+ */
 struct BLEControlsEvent : BLEBaseEvent {
+  /// @brief Left stick deflection along the X-axis, from -32768 to 32767. See `leftStickX()`.
+  int16_t leftStickXRaw{0};
+
+  /// @brief Left stick deflection along the Y-axis, from -32768 to 32767. See `leftStickY()`.
+  int16_t leftStickYRaw{0};
+
+  /// @brief Right stick deflection along the X-axis, from -32768 to 32767. See `rightStickX()`.
+  int16_t rightStickXRaw{0};
+
+  /// @brief Right stick deflection along the Y-axis, from -32768 to 32767. See `rightStickY()`.
+  int16_t rightStickYRaw{0};
+
+  /// @brief Pressure level of the left trigger, from 0 to 65535. See `leftTrigger()`.
+  uint16_t leftTriggerRaw{0};
+
+  /// @brief Pressure level of the right trigger, from 0 to 65535. See `rightTrigger()`.
+  uint16_t rightTriggerRaw{0};
+
+  /// @brief Buttons held down, a combination of `BLEControlsButton` bits.
+  uint16_t buttons{0};
+
+  /// @brief Buttons that were pressed or released since the previous event, a combination of `BLEControlsButton`
+  /// bits. Set together with `buttons` by `setButtons()`.
+  uint16_t changedButtons{0};
+
+  /**
+   * @brief Updates the buttons held down and the buttons changed since the previous state. Meant for decoders, which
+   * update the previous event in place.
+   * @param held Combination of `BLEControlsButton` bits.
+   */
+  void setButtons(uint16_t held) {
+    changedButtons = buttons ^ held;
+    buttons = held;
+  }
+
+  /// @brief Checks if all the given buttons are held down.
+  bool isHeld(uint16_t mask) const { return (buttons & mask) == mask; }
+
+  /// @brief Checks if any of the given buttons went down with this event.
+  bool wasPressed(uint16_t mask) const { return (buttons & changedButtons & mask) != 0; }
+
+  /// @brief Checks if any of the given buttons went up with this event.
+  bool wasReleased(uint16_t mask) const { return (~buttons & changedButtons & mask) != 0; }
+
   /**
    * @brief Left stick deflection along the X-axis. Takes values between -1.0 and 1.0. No deflection should yield 0.0,
    * unless affected by stick drift. Positive values represent deflection to the right, and negative values to the left.
@@ -23,7 +93,7 @@ struct BLEControlsEvent : BLEBaseEvent {
        -1.0   0.0   1.0
    @endverbatim
    */
-  float leftStickX{0.0f};
+  float leftStickX() const { return _axis(leftStickXRaw); }
 
   /**
    * @brief Left stick deflection along the Y-axis. Takes values between -1.0 and 1.0. No deflection should yield 0.0,
@@ -31,7 +101,7 @@ struct BLEControlsEvent : BLEBaseEvent {
    *
    * @copydetails leftStickX
    */
-  float leftStickY{0.0f};
+  float leftStickY() const { return _axis(leftStickYRaw); }
 
   /**
    * @brief Right stick deflection along the X-axis. Takes values between -1.0 and 1.0. No deflection should yield 0.0,
@@ -39,7 +109,7 @@ struct BLEControlsEvent : BLEBaseEvent {
    *
    * @copydetails leftStickX
    */
-  float rightStickX{0.0f};
+  float rightStickX() const { return _axis(rightStickXRaw); }
 
   /**
    * @brief Right stick deflection along the Y-axis. Takes values between -1.0 and 1.0. No deflection should yield 0.0,
@@ -47,61 +117,66 @@ struct BLEControlsEvent : BLEBaseEvent {
    *
    * @copydetails leftStickX
    */
-  float rightStickY{0.0f};
+  float rightStickY() const { return _axis(rightStickYRaw); }
+
+  /// @brief Pressure level of a left trigger. Takes values between 0.0 and 1.0. No pressure should yield 0.0. This
+  /// control is also known as L2.
+  float leftTrigger() const { return _trigger(leftTriggerRaw); }
+
+  /// @brief Pressure level of a right trigger. Takes values between 0.0 and 1.0. No pressure should yield 0.0. This
+  /// control is also known as R2.
+  float rightTrigger() const { return _trigger(rightTriggerRaw); }
 
   /// @brief Button activated when pressing down on the left stick, also known as the L3 button.
-  bool leftStickButton{false};
+  bool leftStickButton() const { return buttons & BLEButtonLeftStick; }
 
   /// @brief Button activated when pressing down on the right stick, also known as the R3 button.
-  bool rightStickButton{false};
+  bool rightStickButton() const { return buttons & BLEButtonRightStick; }
 
   /// @brief Up button on the directional pad.
-  bool dpadUp{false};
+  bool dpadUp() const { return buttons & BLEButtonDpadUp; }
 
   /// @brief Down button on the directional pad.
-  bool dpadDown{false};
+  bool dpadDown() const { return buttons & BLEButtonDpadDown; }
 
   /// @brief Left button on the directional pad.
-  bool dpadLeft{false};
+  bool dpadLeft() const { return buttons & BLEButtonDpadLeft; }
 
   /// @brief Right button on the directional pad.
-  bool dpadRight{false};
+  bool dpadRight() const { return buttons & BLEButtonDpadRight; }
 
   /// @brief Face button A, also known as the cross button.
-  bool buttonA{false};
+  bool buttonA() const { return buttons & BLEButtonA; }
 
   /// @brief Face button B, also known as the circle button.
-  bool buttonB{false};
+  bool buttonB() const { return buttons & BLEButtonB; }
 
-  /// @brief Face button B, also known as the triangle button.
-  bool buttonX{false};
+  /// @brief Face button X, also known as the square button.
+  bool buttonX() const { return buttons & BLEButtonX; }
 
-  /// @brief Face button B, also known as the square button.
-  bool buttonY{false};
+  /// @brief Face button Y, also known as the triangle button.
+  bool buttonY() const { return buttons & BLEButtonY; }
 
   /// @brief Left bumper button, also known as the L1 or L shoulder button.
-  bool leftBumper{false};
+  bool leftBumper() const { return buttons & BLEButtonLeftBumper; }
 
   /// @brief Right bumper button, also known as the R1 or R shoulder button.
-  bool rightBumper{false};
-
-  /// @brief Pressure level of a left trigger. Takes values between 0.0 and 1.0. No pressure should yield 0.0. This
-  /// control is also known as L2.
-  float leftTrigger{0.0f};
-
-  /// @brief Pressure level of a right trigger. Takes values between 0.0 and 1.0. No pressure should yield 0.0. This
-  /// control is also known as R2.
-  float rightTrigger{0.0f};
+  bool rightBumper() const { return buttons & BLEButtonRightBumper; }
 
   /// @brief Share button.
-  bool share{false};
+  bool share() const { return buttons & BLEButtonShare; }
 
   /// @brief Menu button, also known as start button.
-  bool menu{false};
+  bool menu() const { return buttons & BLEButtonMenu; }
 
   /// @brief View button, also known as back button.
-  bool view{false};
+  bool view() const { return buttons & BLEButtonView; }
 
   /// @brief Xbox button, also known as guide button.
-  bool xbox{false};
+  bool xbox() const { return buttons & BLEButtonXbox; }
+
+ private:
+  // -32768 has no opposite, it reads as full deflection like -32767
+  static float _axis(int16_t raw) { return (raw < -32767 ? -32767 : raw) / 32767.0f; }
+  static float _trigger(uint16_t raw) { return raw / 65535.0f; }
 };
@@ -0,0 +1,89 @@
+#include "BLEDispatcher.h"
+
+#include <NimBLEDevice.h>
+#include "config.h"
+#include "logger.h"
+
+static auto* LOG_TAG = "BLEDispatcher";
+
+BLEDispatcher::BLEDispatcher() : _initialized(false), _jobQueue(nullptr), _dispatchTask(nullptr) {}
+
+/**
+ * @brief Creates the job queue and the dispatch task.
+ * @return True if successful.
+ */
+bool BLEDispatcher::init() {
+  if (_initialized) {
+    return false;
+  }
+
+  _jobQueue = xQueueCreate(CONFIG_BT_BLEGC_DISPATCH_QUEUE_LEN, sizeof(Job));
+  configASSERT(_jobQueue);
+  xTaskCreate(_dispatchTaskFn, "_dispatchTask", CONFIG_BT_BLEGC_DISPATCH_STACK_SIZE, this,
+              CONFIG_BT_BLEGC_DISPATCH_PRIORITY, &_dispatchTask);
+  configASSERT(_dispatchTask);
+
+  _initialized = true;
+  return true;
+}
+
+/**
+ * @brief Deletes the dispatch task, jobs still in the queue are dropped.
+ * @return True if successful.
+ */
+bool BLEDispatcher::deinit() {
+  if (!_initialized) {
+    return false;
+  }
+
+  _initialized = false;
+
+  if (_dispatchTask != nullptr) {
+    vTaskDelete(_dispatchTask);
+    _dispatchTask = nullptr;
+  }
+  if (_jobQueue != nullptr) {
+    vQueueDelete(_jobQueue);
+    _jobQueue = nullptr;
+  }
+
+  return true;
+}
+
+bool BLEDispatcher::isInitialized() const {
+  return _initialized;
+}
+
+/**
+ * @brief Queues a job for the dispatch task. Never blocks, callers are expected to keep at most one job of their own
+ * in the queue, so that the queue length only depends on the number of signals.
+ * @param fn Function to call from the dispatch task.
+ * @param pArg Argument passed to `fn`, it must outlive the job.
+ * @return True if the job was queued; false if the dispatcher is not initialized or the queue is full.
+ */
+bool BLEDispatcher::post(JobFn fn, void* pArg) {
+  if (!_initialized) {
+    return false;
+  }
+
+  Job job{fn, pArg};
+  if (xQueueSend(_jobQueue, &job, 0) != pdTRUE) {
+    BLEGC_LOGW(LOG_TAG, "Job queue full, job dropped");
+    return false;
+  }
+  return true;
+}
+
+void BLEDispatcher::_dispatchTaskFn(void* pvParameters) {
+  auto* self = static_cast<BLEDispatcher*>(pvParameters);
+
+  while (true) {
+    Job job{};
+    if (xQueueReceive(self->_jobQueue, &job, portMAX_DELAY) != pdTRUE) {
+      BLEGC_LOGE(LOG_TAG, "Failed to receive job");
+      continue;
+    }
+
+    job.fn(job.pArg);
+  }
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <NimBLEDevice.h>
+
+/// @brief Runs the work of all signals that must not run in the NimBLE host task, i.e. `onUpdate` callbacks and
+/// outgoing writes, on a single task fed by a bounded queue.
+class BLEDispatcher {
+ public:
+  using JobFn = void (*)(void* pArg);
+
+  BLEDispatcher();
+  ~BLEDispatcher() = default;
+  bool init();
+  bool deinit();
+  bool isInitialized() const;
+  bool post(JobFn fn, void* pArg);
+
+ private:
+  struct Job {
+    JobFn fn;
+    void* pArg;
+  };
+  static void _dispatchTaskFn(void* pvParameters);
+  bool _initialized;
+  QueueHandle_t _jobQueue;
+  TaskHandle_t _dispatchTask;
+};
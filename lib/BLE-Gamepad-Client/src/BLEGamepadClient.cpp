@@ -4,6 +4,7 @@
 #include "BLEAutoScanner.h"
 #include "BLEDeviceMatcher.h"
 #include "BLEControllerRegistry.h"
+#include "BLEDispatcher.h"
 #include "logger.h"
 
 static auto* LOG_TAG = "BLEGamepadClient";
@@ -12,7 +13,8 @@ bool BLEGamepadClient::_initialized(false);
 bool BLEGamepadClient::_deleteBonds(false);
 TaskHandle_t BLEGamepadClient::_autoScanTask;
 BLEDeviceMatcher BLEGamepadClient::_matcher;
-BLEControllerRegistry BLEGamepadClient::_controllerRegistry(_autoScanTask, _matcher);
+BLEDispatcher BLEGamepadClient::_dispatcher;
+BLEControllerRegistry BLEGamepadClient::_controllerRegistry(_autoScanTask, _matcher, _dispatcher);
 BLEAutoScanner BLEGamepadClient::_autoScanner(_autoScanTask, _controllerRegistry, _matcher);
 
 bool BLEGamepadClient::init() {
@@ -37,13 +39,20 @@ bool BLEGamepadClient::init() {
     return false;
   }
 
+  if (!_dispatcher.init()) {
+    _matcher.deinit();
+    return false;
+  }
+
   if (!_controllerRegistry.init()) {
+    _dispatcher.deinit();
     _matcher.deinit();
     return false;
   }
 
   if (!_autoScanner.init()) {
     _controllerRegistry.deinit();
+    _dispatcher.deinit();
     _matcher.deinit();
     return false;
   }
@@ -62,7 +71,9 @@ bool BLEGamepadClient::deinit() {
   auto result = true;
 
   result = result && _autoScanner.deinit();
+  // The registry deinitializes the controllers, whose signals may still post jobs to the dispatcher
   result = result && _controllerRegistry.deinit();
+  result = result && _dispatcher.deinit();
   result = result && _matcher.deinit();
 
   _initialized = false;
@@ -4,6 +4,7 @@
 #include "BLEController.h"
 #include "BLEDeviceMatcher.h"
 #include "BLEControllerRegistry.h"
+#include "BLEDispatcher.h"
 
 class BLEGamepadClient {
  public:
@@ -26,5 +27,6 @@ class BLEGamepadClient {
   static TaskHandle_t _autoScanTask;
   static BLEAutoScanner _autoScanner;
   static BLEDeviceMatcher _matcher;
+  static BLEDispatcher _dispatcher;
   static BLEControllerRegistry _controllerRegistry;
 };
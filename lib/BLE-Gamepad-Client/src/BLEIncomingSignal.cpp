@@ -9,16 +9,18 @@
 static auto* LOG_TAG = "BLEIncomingSignal";
 
 template <typename T>
-BLEIncomingSignal<T>::BLEIncomingSignal()
+BLEIncomingSignal<T>::BLEIncomingSignal(BLEDispatcher& dispatcher)
     : _initialized(false),
+      _dispatcher(dispatcher),
+      _updatePending(false),
       _onUpdate([](T&) {}),
       _onUpdateSet(false),
+      _onDecode([](const T&) {}),
       _decoder([](T&, uint8_t[], size_t) { return 1; }),
       _address(),
       _pChar(nullptr),
-      _onUpdateTask(nullptr),
-      _storeMutex(nullptr),
-      _store({.event = T()}) {}
+      _decoded(),
+      _seq(0) {}
 
 template <typename T>
 bool BLEIncomingSignal<T>::init(NimBLEAddress address, Spec& spec) {
@@ -27,10 +29,10 @@ bool BLEIncomingSignal<T>::init(NimBLEAddress address, Spec& spec) {
   }
   _address = address;
 
-  _storeMutex = xSemaphoreCreateMutex();
-  configASSERT(_storeMutex);
-  xTaskCreate(_onUpdateTaskFn, "_onUpdateTask", 10000, this, 0, &_onUpdateTask);
-  configASSERT(_onUpdateTask);
+  // Start from an empty event, `read()` must not return the last one of a previous connection and the decoders must
+  // not update it in place. Nothing reads or publishes before the subscription below.
+  _decoded = T();
+  _seq.store(0, std::memory_order_release);
 
   _decoder = spec.decoder;
   _pChar = blegc::findCharacteristic(_address, spec.serviceUUID, spec.characteristicUUID,
@@ -73,13 +75,6 @@ bool BLEIncomingSignal<T>::deinit(bool disconnected) {
     }
   }
 
-  if (_onUpdateTask != nullptr) {
-    vTaskDelete(_onUpdateTask);
-  }
-  if (_storeMutex != nullptr) {
-    vSemaphoreDelete(_storeMutex);
-  }
-
   _pChar = nullptr;
 
   _initialized = false;
@@ -91,15 +86,40 @@ bool BLEIncomingSignal<T>::isInitialized() const {
   return _initialized;
 }
 
+/**
+ * @brief Copies the latest decoded event. Lock-free: the NimBLE host task publishes into the slots in turn, so a copy
+ * is only retried if `slotCount` (3) events were published while it was being made and the slot was reused.
+ * @param[out] out Reference to the event instance where the data will be written.
+ * @return Sequence number of the event, incremented with every decoded notification. 0 if nothing was received yet
+ * or the signal is not initialized, `out` is left untouched then.
+ */
 template <typename T>
-void BLEIncomingSignal<T>::read(T& out) {
+uint32_t BLEIncomingSignal<T>::read(T& out) const {
   if (!_initialized) {
-    return;
+    return 0;
   }
 
-  configASSERT(xSemaphoreTake(_storeMutex, portMAX_DELAY));
-  out = _store.event;
-  configASSERT(xSemaphoreGive(_storeMutex));
+  while (true) {
+    auto seq = _seq.load(std::memory_order_acquire);
+    if (seq == 0) {
+      return 0;
+    }
+    auto& slot = _slots[seq % slotCount];
+    out = slot.event;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.seq.load(std::memory_order_relaxed) == seq) {
+      return seq;
+    }
+  }
+}
+
+/**
+ * @brief Sequence number of the latest decoded event, compare with a previous result of `read()` to check if
+ * anything changed without copying the event.
+ */
+template <typename T>
+uint32_t BLEIncomingSignal<T>::getSequence() const {
+  return _seq.load(std::memory_order_acquire);
 }
 
 template <typename T>
@@ -108,16 +128,26 @@ void BLEIncomingSignal<T>::onUpdate(const OnUpdate<T>& onUpdate) {
   _onUpdateSet = true;
 }
 
+/**
+ * @brief Sets a callback run in the NimBLE host task right after each event is decoded, before the `onUpdate`
+ * callback is dispatched. It must be short and must not block.
+ */
 template <typename T>
-void BLEIncomingSignal<T>::_onUpdateTaskFn(void* pvParameters) {
-  auto* self = static_cast<BLEIncomingSignal*>(pvParameters);
+void BLEIncomingSignal<T>::onDecode(const OnDecode<T>& onDecode) {
+  _onDecode = onDecode;
+}
 
-  while (true) {
-    ulTaskNotifyTake(pdFALSE, portMAX_DELAY);
+/**
+ * @brief Calls the `onUpdate` callback with the latest event, from the dispatch task. Notifications received while
+ * the job is queued are coalesced into it.
+ */
+template <typename T>
+void BLEIncomingSignal<T>::_dispatchUpdate(void* pArg) {
+  auto* self = static_cast<BLEIncomingSignal*>(pArg);
 
-    configASSERT(xSemaphoreTake(self->_storeMutex, portMAX_DELAY));
-    auto eventCopy = self->_store.event;
-    configASSERT(xSemaphoreGive(self->_storeMutex));
+  self->_updatePending.store(false);
+  T eventCopy;
+  if (self->read(eventCopy) > 0) {
     self->_onUpdate(eventCopy);
   }
 }
@@ -127,19 +157,43 @@ void BLEIncomingSignal<T>::_handleNotify(NimBLERemoteCharacteristic* pChar,
                                          uint8_t* pData,
                                          size_t length,
                                          bool isNotify) {
+  uint32_t timeUs = micros();
   BLEGC_LOGT(LOG_TAG, "Received a notification. %s", blegc::remoteCharToStr(pChar).c_str());
 
-  configASSERT(xSemaphoreTake(_storeMutex, portMAX_DELAY));
-  auto result = _decoder(_store.event, pData, length) > 0;
-  configASSERT(xSemaphoreGive(_storeMutex));
+  // Decoders update the previous event in place, `_decoded` is only touched by the NimBLE host task
+  auto result = _decoder(_decoded, pData, length) > 0;
 
   if (!result) {
     BLEGC_LOGE(LOG_TAG, "Decoding failed. %s", blegc::remoteCharToStr(pChar).c_str());
+  } else {
+    _decoded.timeUs = timeUs;
+    _publish();
+    _onDecode(_decoded);
   }
 
-  if (_onUpdateSet && result) {
-    xTaskNotifyGive(_onUpdateTask);
+  if (_onUpdateSet && result && !_updatePending.exchange(true)) {
+    if (!_dispatcher.post(_dispatchUpdate, this)) {
+      _updatePending.store(false);
+    }
+  }
+}
+
+/**
+ * @brief Copies the decoded event into the slot after the latest one and makes it the latest. Called from the NimBLE
+ * host task only, readers never make it wait.
+ */
+template <typename T>
+void BLEIncomingSignal<T>::_publish() {
+  auto seq = _seq.load(std::memory_order_relaxed) + 1;
+  if (seq == writingSeq) {
+    seq = 1;
   }
+  auto& slot = _slots[seq % slotCount];
+  slot.seq.store(writingSeq, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.event = _decoded;
+  slot.seq.store(seq, std::memory_order_release);
+  _seq.store(seq, std::memory_order_release);
 }
 
 template <typename T>
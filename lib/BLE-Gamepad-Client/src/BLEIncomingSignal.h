@@ -1,13 +1,18 @@
 #pragma once
 
 #include <NimBLEDevice.h>
+#include <atomic>
 #include <functional>
 #include "BLEBatteryEvent.h"
 #include "BLEControlsEvent.h"
+#include "BLEDispatcher.h"
 
 template <typename T>
 using OnUpdate = std::function<void(T& value)>;
 
+template <typename T>
+using OnDecode = std::function<void(const T& value)>;
+
 template <typename T>
 class BLEIncomingSignal {
  public:
@@ -22,29 +27,40 @@ class BLEIncomingSignal {
     explicit operator std::string() const;
   };
 
-  BLEIncomingSignal();
+  explicit BLEIncomingSignal(BLEDispatcher& dispatcher);
   ~BLEIncomingSignal() = default;
   bool init(NimBLEAddress address, Spec& spec);
   bool deinit(bool disconnected);
   bool isInitialized() const;
-  void read(T& out);
+  uint32_t read(T& out) const;
+  uint32_t getSequence() const;
   void onUpdate(const OnUpdate<T>& onUpdate);
+  void onDecode(const OnDecode<T>& onDecode);
 
  private:
-  struct Store {
-    T event;
+  /// @brief One published event. `seq` is the sequence number of the event it holds, or `writingSeq` while the
+  /// NimBLE host task overwrites it.
+  struct Slot {
+    std::atomic<uint32_t> seq{0};
+    T event{};
   };
-  static void _onUpdateTaskFn(void* pvParameters);
+  static constexpr size_t slotCount = 3;
+  static constexpr uint32_t writingSeq = UINT32_MAX;
+  void _publish();
+  static void _dispatchUpdate(void* pArg);
   void _handleNotify(NimBLERemoteCharacteristic* pChar, uint8_t* pData, size_t length, bool isNotify);
   bool _initialized;
+  BLEDispatcher& _dispatcher;
+  std::atomic<bool> _updatePending;
   OnUpdate<T> _onUpdate;
   bool _onUpdateSet;
+  OnDecode<T> _onDecode;
   Decoder _decoder;
   NimBLEAddress _address;
   NimBLERemoteCharacteristic* _pChar;
-  TaskHandle_t _onUpdateTask;
-  SemaphoreHandle_t _storeMutex;
-  Store _store;
+  T _decoded;
+  std::atomic<uint32_t> _seq;
+  Slot _slots[slotCount];
 };
 
 template class BLEIncomingSignal<BLEControlsEvent>;
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdint.h>
+
+enum BLEInputEventKind : uint8_t { BLEInputPressed = 0, BLEInputReleased = 1, BLEInputAxisMoved = 2 };
+
+/// @brief Sticks and triggers of `BLEControlsEvent`, in the order of its raw members.
+enum BLEInputAxis : uint8_t {
+  BLEAxisLeftStickX = 0,
+  BLEAxisLeftStickY = 1,
+  BLEAxisRightStickX = 2,
+  BLEAxisRightStickY = 3,
+  BLEAxisLeftTrigger = 4,
+  BLEAxisRightTrigger = 5,
+  BLEAxisCount = 6,
+};
+
+/**
+ * @brief A single change of the controls: a button going down or up, or an axis moving by more than
+ * `CONFIG_BT_BLEGC_AXIS_DEADBAND` since it was last reported.
+ */
+struct BLEInputEvent {
+  /// @brief `micros()` when the notification carrying the change arrived. For a coalesced axis event, the time of the
+  /// latest notification.
+  uint32_t timeUs{0};
+
+  BLEInputEventKind kind{BLEInputPressed};
+
+  /// @brief Bit number of the `BLEControlsButton` for `BLEInputPressed` and `BLEInputReleased`, `BLEInputAxis`
+  /// for `BLEInputAxisMoved`.
+  uint8_t index{0};
+
+  /// @brief New raw value of the axis, as in the matching `BLEControlsEvent` member. Sticks are signed.
+  uint16_t raw{0};
+
+  /// @brief The `BLEControlsButton` bit of a button event.
+  uint16_t button() const { return kind == BLEInputAxisMoved ? 0 : 1 << index; }
+
+  /// @brief The axis of an axis event.
+  BLEInputAxis axis() const { return static_cast<BLEInputAxis>(index); }
+
+  /// @brief New value of the axis, between -1.0 and 1.0 for sticks and between 0.0 and 1.0 for triggers, as returned
+  /// by the accessors of `BLEControlsEvent`.
+  float value() const {
+    if (index >= BLEAxisLeftTrigger) {
+      return raw / 65535.0f;
+    }
+    auto stick = static_cast<int16_t>(raw);
+    return (stick < -32767 ? -32767 : stick) / 32767.0f;
+  }
+};
@@ -0,0 +1,148 @@
+#include "BLEInputEventQueue.h"
+
+#include <NimBLEDevice.h>
+#include "logger.h"
+
+static auto* LOG_TAG = "BLEInputEventQueue";
+
+BLEInputEventQueue::BLEInputEventQueue(BLEDispatcher& dispatcher)
+    : _dispatcher(dispatcher),
+      _dispatchPending(false),
+      _onEvent([](BLEInputEvent&) {}),
+      _onEventSet(false) {
+  reset();
+}
+
+/**
+ * @brief Drops the queued events and forgets the reported state, e.g. when a controller connects. Buttons already
+ * held and axes away from 0 are reported by the first notification.
+ */
+void BLEInputEventQueue::reset() {
+  portENTER_CRITICAL(&_lock);
+  _head = 0;
+  _count = 0;
+  _reportedButtons = 0;
+  for (size_t i = 0; i < BLEAxisCount; i++) {
+    _reportedAxes[i] = 0;
+    _pendingAxes[i] = -1;
+  }
+  portEXIT_CRITICAL(&_lock);
+}
+
+/**
+ * @brief Queues the changes of a decoded event against the state reported so far. Called from the NimBLE host task.
+ *
+ * A move of an axis that still has an event in the queue updates that event instead of adding one, so under load the
+ * queue holds at most one event per axis and the buttons fill the rest. When the queue is full a change is not
+ * reported yet and comes out with a later notification, against the state reported so far. A button pressed and
+ * released while the queue is full is therefore not reported at all, only the net state of every button is.
+ * @param e The decoded event.
+ * @param timeUs `micros()` when its notification arrived.
+ */
+void BLEInputEventQueue::push(const BLEControlsEvent& e, uint32_t timeUs) {
+  const int32_t axes[BLEAxisCount] = {e.leftStickXRaw,  e.leftStickYRaw,  e.rightStickXRaw,
+                                      e.rightStickYRaw, e.leftTriggerRaw, e.rightTriggerRaw};
+  auto queued = false;
+  auto full = false;
+
+  portENTER_CRITICAL(&_lock);
+  uint16_t changed = e.buttons ^ _reportedButtons;
+  for (uint8_t bit = 0; changed != 0; bit++, changed >>= 1) {
+    if ((changed & 1) == 0) {
+      continue;
+    }
+    uint16_t mask = 1 << bit;
+    if (!_append(e.buttons & mask ? BLEInputPressed : BLEInputReleased, bit, 0, timeUs)) {
+      full = true;
+      break;
+    }
+    _reportedButtons ^= mask;
+    queued = true;
+  }
+
+  for (uint8_t i = 0; i < BLEAxisCount; i++) {
+    auto delta = axes[i] - _reportedAxes[i];
+    if (delta <= CONFIG_BT_BLEGC_AXIS_DEADBAND && delta >= -CONFIG_BT_BLEGC_AXIS_DEADBAND) {
+      continue;
+    }
+    if (!_pushAxis(static_cast<BLEInputAxis>(i), axes[i], timeUs)) {
+      full = true;
+      continue;
+    }
+    queued = true;
+  }
+  portEXIT_CRITICAL(&_lock);
+
+  if (full) {
+    BLEGC_LOGD(LOG_TAG, "Input event queue full, changes deferred");
+  }
+
+  if (queued && _onEventSet && !_dispatchPending.exchange(true)) {
+    if (!_dispatcher.post(_dispatchEvents, this)) {
+      _dispatchPending.store(false);
+    }
+  }
+}
+
+/**
+ * @brief Takes the oldest event from the queue.
+ * @param[out] out Reference to the event instance where the data will be written.
+ * @return True if an event was read; false if the queue is empty.
+ */
+bool BLEInputEventQueue::pop(BLEInputEvent& out) {
+  portENTER_CRITICAL(&_lock);
+  auto result = _count > 0;
+  if (result) {
+    out = _events[_head];
+    if (out.kind == BLEInputAxisMoved) {
+      _pendingAxes[out.index] = -1;
+    }
+    _head = (_head + 1) % capacity;
+    _count--;
+  }
+  portEXIT_CRITICAL(&_lock);
+  return result;
+}
+
+void BLEInputEventQueue::onEvent(const OnInputEvent& onEvent) {
+  _onEvent = onEvent;
+  _onEventSet = true;
+}
+
+void BLEInputEventQueue::_dispatchEvents(void* pArg) {
+  auto* self = static_cast<BLEInputEventQueue*>(pArg);
+
+  self->_dispatchPending.store(false);
+  BLEInputEvent event;
+  while (self->pop(event)) {
+    self->_onEvent(event);
+  }
+}
+
+bool BLEInputEventQueue::_append(BLEInputEventKind kind, uint8_t index, uint16_t raw, uint32_t timeUs) {
+  if (_count == capacity) {
+    return false;
+  }
+  auto& event = _events[(_head + _count) % capacity];
+  event.timeUs = timeUs;
+  event.kind = kind;
+  event.index = index;
+  event.raw = raw;
+  _count++;
+  return true;
+}
+
+bool BLEInputEventQueue::_pushAxis(BLEInputAxis axis, int32_t value, uint32_t timeUs) {
+  auto pending = _pendingAxes[axis];
+  if (pending >= 0) {
+    _events[pending].raw = static_cast<uint16_t>(value);
+    _events[pending].timeUs = timeUs;
+  } else {
+    if (!_append(BLEInputAxisMoved, axis, static_cast<uint16_t>(value), timeUs)) {
+      return false;
+    }
+    _pendingAxes[axis] = static_cast<int16_t>((_head + _count - 1) % capacity);
+  }
+  _reportedAxes[axis] = value;
+  return true;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <NimBLEDevice.h>
+#include <atomic>
+#include <functional>
+#include "BLEControlsEvent.h"
+#include "BLEDispatcher.h"
+#include "BLEInputEvent.h"
+#include "config.h"
+
+using OnInputEvent = std::function<void(BLEInputEvent& e)>;
+
+/// @brief Turns the decoded controls into button edges and axis moves, kept in a bounded queue until read or handed
+/// to the `onEvent` callback.
+class BLEInputEventQueue {
+ public:
+  explicit BLEInputEventQueue(BLEDispatcher& dispatcher);
+  ~BLEInputEventQueue() = default;
+  void reset();
+  void push(const BLEControlsEvent& e, uint32_t timeUs);
+  bool pop(BLEInputEvent& out);
+  void onEvent(const OnInputEvent& onEvent);
+
+ private:
+  static constexpr size_t capacity = CONFIG_BT_BLEGC_INPUT_QUEUE_LEN;
+  static void _dispatchEvents(void* pArg);
+  bool _append(BLEInputEventKind kind, uint8_t index, uint16_t raw, uint32_t timeUs);
+  bool _pushAxis(BLEInputAxis axis, int32_t value, uint32_t timeUs);
+  BLEDispatcher& _dispatcher;
+  std::atomic<bool> _dispatchPending;
+  OnInputEvent _onEvent;
+  bool _onEventSet;
+  portMUX_TYPE _lock = portMUX_INITIALIZER_UNLOCKED;
+  BLEInputEvent _events[capacity];
+  size_t _head;
+  size_t _count;
+  uint16_t _reportedButtons;
+  int32_t _reportedAxes[BLEAxisCount];
+  int16_t _pendingAxes[BLEAxisCount];  // queue position of an axis event not read yet, -1 if none
+};
@@ -11,14 +11,23 @@ static auto* LOG_TAG = "BLEOutgoingSignal";
 constexpr size_t maxCapacity = 1024;
 
 template <typename T>
-BLEOutgoingSignal<T>::BLEOutgoingSignal()
+BLEOutgoingSignal<T>::BLEOutgoingSignal(BLEDispatcher& dispatcher)
     : _initialized(false),
+      _dispatcher(dispatcher),
+      _writePending(false),
       _encoder([](const T&, uint8_t[], size_t) { return static_cast<size_t>(0); }),
       _address(),
       _pChar(nullptr),
-      _sendDataTask(nullptr),
       _storeMutex(nullptr) {}
 
+template <typename T>
+BLEOutgoingSignal<T>::~BLEOutgoingSignal() {
+  delete[] _store.pBuffer;
+  if (_storeMutex != nullptr) {
+    vSemaphoreDelete(_storeMutex);
+  }
+}
+
 template <typename T>
 bool BLEOutgoingSignal<T>::init(NimBLEAddress address, Spec& spec) {
   if (_initialized) {
@@ -29,7 +38,6 @@ bool BLEOutgoingSignal<T>::init(NimBLEAddress address, Spec& spec) {
 
   _store.capacity = spec.bufferLen > 0 ? spec.bufferLen : 8;
   _store.pBuffer = new uint8_t[_store.capacity];
-  _store.pSendBuffer = new uint8_t[_store.capacity];
 
   _encoder = spec.encoder;
   _pChar = blegc::findCharacteristic(_address, spec.serviceUUID, spec.characteristicUUID,
@@ -38,10 +46,11 @@ bool BLEOutgoingSignal<T>::init(NimBLEAddress address, Spec& spec) {
     return false;
   }
 
-  _storeMutex = xSemaphoreCreateMutex();
-  configASSERT(_storeMutex);
-  xTaskCreate(_sendDataFn, "_sendDataFn", 10000, this, 0, &_sendDataTask);
-  configASSERT(_sendDataTask);
+  // Kept across reconnects, a write job of the previous connection may still be queued
+  if (_storeMutex == nullptr) {
+    _storeMutex = xSemaphoreCreateMutex();
+    configASSERT(_storeMutex);
+  }
 
   _initialized = true;
   return true;
@@ -53,19 +62,15 @@ bool BLEOutgoingSignal<T>::deinit(bool disconnected) {
     return false;
   }
 
-  if (_sendDataTask != nullptr) {
-    vTaskDelete(_sendDataTask);
-  }
-  if (_storeMutex != nullptr) {
-    vSemaphoreDelete(_storeMutex);
-  }
-
+  configASSERT(xSemaphoreTake(_storeMutex, portMAX_DELAY));
   _pChar = nullptr;
 
   delete[] _store.pBuffer;
-  delete[] _store.pSendBuffer;
+  _store.pBuffer = nullptr;
+  _store.used = 0;
 
   _initialized = false;
+  configASSERT(xSemaphoreGive(_storeMutex));
   return true;
 }
 
@@ -81,13 +86,16 @@ void BLEOutgoingSignal<T>::write(const T& value) {
   }
 
   configASSERT(xSemaphoreTake(_storeMutex, portMAX_DELAY));
+  if (!_initialized) {
+    configASSERT(xSemaphoreGive(_storeMutex));
+    return;
+  }
+
   size_t used;
   while ((used = _encoder(value, _store.pBuffer, _store.capacity)) == 0 && _store.capacity < maxCapacity) {
     delete[] _store.pBuffer;
-    delete[] _store.pSendBuffer;
     _store.capacity = min(_store.capacity * 2, maxCapacity);
     _store.pBuffer = new uint8_t[_store.capacity];
-    _store.pSendBuffer = new uint8_t[_store.capacity];
   }
 
   _store.used = used;
@@ -99,40 +107,41 @@ void BLEOutgoingSignal<T>::write(const T& value) {
     return;
   }
 
-  xTaskNotifyGive(_sendDataTask);
+  if (!_writePending.exchange(true)) {
+    if (!_dispatcher.post(_dispatchWrite, this)) {
+      _writePending.store(false);
+    }
+  }
 }
 
+/**
+ * @brief Sends the latest encoded value, from the dispatch task. Values written while the job is queued replace the
+ * previous one, only the last is sent.
+ */
 template <typename T>
-void BLEOutgoingSignal<T>::_sendDataFn(void* pvParameters) {
-  auto* self = static_cast<BLEOutgoingSignal*>(pvParameters);
-
-  while (true) {
-    ulTaskNotifyTake(pdFALSE, portMAX_DELAY);
+void BLEOutgoingSignal<T>::_dispatchWrite(void* pArg) {
+  auto* self = static_cast<BLEOutgoingSignal*>(pArg);
 
-    configASSERT(xSemaphoreTake(self->_storeMutex, portMAX_DELAY));
+  self->_writePending.store(false);
 
-    uint8_t* tmp = self->_store.pSendBuffer;
-    self->_store.pSendBuffer = self->_store.pBuffer;
-    self->_store.pBuffer = tmp;
+  // Held while sending, so that deinit cannot free the buffer under the write
+  configASSERT(xSemaphoreTake(self->_storeMutex, portMAX_DELAY));
 
-    auto used = self->_store.used;
-    auto result = self->_store.used > 0 && self->_store.used <= self->_store.capacity;
-    configASSERT(xSemaphoreGive(self->_storeMutex));
-
-    if (!result) {
-      BLEGC_LOGE(LOG_TAG, "Encoding failed");
-      continue;
-    }
-
-    if (!self->_pChar) {
-      BLEGC_LOGE(LOG_TAG, "Remote characteristic not initialized");
-      continue;
-    }
+  auto used = self->_store.used;
+  auto result = self->_store.used > 0 && self->_store.used <= self->_store.capacity;
 
+  if (!self->_initialized) {
+    // disconnected after the job was queued
+  } else if (!self->_pChar) {
+    BLEGC_LOGE(LOG_TAG, "Remote characteristic not initialized");
+  } else if (!result) {
+    BLEGC_LOGE(LOG_TAG, "Encoding failed");
+  } else {
     BLEGC_LOGT(LOG_TAG, "Writing value. %s", blegc::remoteCharToStr(self->_pChar).c_str());
-
-    self->_pChar->writeValue(self->_store.pSendBuffer, used);
+    self->_pChar->writeValue(self->_store.pBuffer, used);
   }
+
+  configASSERT(xSemaphoreGive(self->_storeMutex));
 }
 
 template <typename T>
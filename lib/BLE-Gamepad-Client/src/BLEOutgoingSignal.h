@@ -1,6 +1,8 @@
 #pragma once
 
 #include <NimBLEDevice.h>
+#include <atomic>
+#include "BLEDispatcher.h"
 #include "BLEVibrationsCommand.h"
 
 template <typename T>
@@ -21,8 +23,8 @@ class BLEOutgoingSignal {
     explicit operator std::string() const;
   };
 
-  BLEOutgoingSignal();
-  ~BLEOutgoingSignal() = default;
+  explicit BLEOutgoingSignal(BLEDispatcher& dispatcher);
+  ~BLEOutgoingSignal();
   bool init(NimBLEAddress address, Spec& spec);
   bool deinit(bool disconnected);
   bool isInitialized() const;
@@ -31,16 +33,16 @@ class BLEOutgoingSignal {
  private:
   struct Store {
     uint8_t* pBuffer{};
-    uint8_t* pSendBuffer{};
     size_t used{};
     size_t capacity{};
   };
-  static void _sendDataFn(void* pvParameters);
+  static void _dispatchWrite(void* pArg);
   bool _initialized;
+  BLEDispatcher& _dispatcher;
+  std::atomic<bool> _writePending;
   Encoder _encoder;
   NimBLEAddress _address;
   NimBLERemoteCharacteristic* _pChar;
-  TaskHandle_t _sendDataTask;
   SemaphoreHandle_t _storeMutex;
   Store _store;
 };
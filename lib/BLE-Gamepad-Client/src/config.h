@@ -23,6 +23,26 @@
 #define CONFIG_BT_BLEGC_CONN_TIMEOUT_MS 15000
 #endif
 
+#ifndef CONFIG_BT_BLEGC_DISPATCH_QUEUE_LEN
+#define CONFIG_BT_BLEGC_DISPATCH_QUEUE_LEN (4 * CONFIG_BT_NIMBLE_MAX_CONNECTIONS)
+#endif
+
+#ifndef CONFIG_BT_BLEGC_DISPATCH_STACK_SIZE
+#define CONFIG_BT_BLEGC_DISPATCH_STACK_SIZE 10000
+#endif
+
+#ifndef CONFIG_BT_BLEGC_DISPATCH_PRIORITY
+#define CONFIG_BT_BLEGC_DISPATCH_PRIORITY 0
+#endif
+
+#ifndef CONFIG_BT_BLEGC_INPUT_QUEUE_LEN
+#define CONFIG_BT_BLEGC_INPUT_QUEUE_LEN 32
+#endif
+
+#ifndef CONFIG_BT_BLEGC_AXIS_DEADBAND
+#define CONFIG_BT_BLEGC_AXIS_DEADBAND 256
+#endif
+
 #ifndef CONFIG_BT_BLEGC_DEVICE_NAME
 #define CONFIG_BT_BLEGC_DEVICE_NAME "BLE ChikoBot"
 #endif
@@ -15,19 +15,35 @@ constexpr size_t controlsPayloadLen = 16;
 constexpr size_t batteryPayloadLen = 1;
 constexpr size_t vibrationsPayloadLen = 8;
 
-constexpr uint16_t axisMax = 0xffff;
 constexpr uint16_t triggerMax = 0x3ff;
 
-inline float decodeStickX(uint16_t val) {
-  return ((2.0f * val) / axisMax) - 1.0f;
+// Hat switch values 0 to 8 of byte 12, 0 is centered
+constexpr uint16_t dpadButtons[] = {
+    0,
+    BLEButtonDpadUp,
+    BLEButtonDpadUp | BLEButtonDpadRight,
+    BLEButtonDpadRight,
+    BLEButtonDpadRight | BLEButtonDpadDown,
+    BLEButtonDpadDown,
+    BLEButtonDpadDown | BLEButtonDpadLeft,
+    BLEButtonDpadLeft,
+    BLEButtonDpadLeft | BLEButtonDpadUp,
+};
+
+// Centered, positive to the right
+inline int16_t decodeStickX(uint16_t val) {
+  return static_cast<int16_t>(val ^ 0x8000);
 }
 
-inline float decodeStickY(uint16_t val) {
-  return ((-2.0f * val) / axisMax) + 1.0f;
+// Centered, positive upwards
+inline int16_t decodeStickY(uint16_t val) {
+  return static_cast<int16_t>(~(val ^ 0x8000));
 }
 
-inline float decodeTrigger(uint16_t val) {
-  return (1.0f * val) / triggerMax;
+// 10 bits scaled to 16
+inline uint16_t decodeTrigger(uint16_t val) {
+  val &= triggerMax;
+  return (val << 6) | (val >> 4);
 }
 
 inline uint16_t uint16(uint8_t r, uint8_t l) {
@@ -41,10 +57,6 @@ constexpr uint8_t mask(int bit) {
   return uint8_t(1) << bit;
 }
 
-inline bool decodeButton(uint8_t byte, int bit) {
-  return byte & mask(bit);
-}
-
 inline void printBits(uint8_t byte, int label) {
   auto bits = std::bitset<8>(byte);
   BLEGC_LOGI(LOG_TAG, "Byte %d: %s", label, bits.to_string().c_str());
@@ -56,46 +68,21 @@ size_t decodeControlsEvent(BLEControlsEvent& e, uint8_t payload[], size_t payloa
     return 0;
   }
 
-  e.leftStickX = decodeStickX(uint16(payload[0], payload[1]));
-  e.leftStickY = decodeStickY(uint16(payload[2], payload[3]));
-  e.rightStickX = decodeStickX(uint16(payload[4], payload[5]));
-  e.rightStickY = decodeStickY(uint16(payload[6], payload[7]));
-  e.leftTrigger = decodeTrigger(uint16(payload[8], payload[9]));
-  e.rightTrigger = decodeTrigger(uint16(payload[10], payload[11]));
+  e.leftStickXRaw = decodeStickX(uint16(payload[0], payload[1]));
+  e.leftStickYRaw = decodeStickY(uint16(payload[2], payload[3]));
+  e.rightStickXRaw = decodeStickX(uint16(payload[4], payload[5]));
+  e.rightStickYRaw = decodeStickY(uint16(payload[6], payload[7]));
+  e.leftTriggerRaw = decodeTrigger(uint16(payload[8], payload[9]));
+  e.rightTriggerRaw = decodeTrigger(uint16(payload[10], payload[11]));
 
-  // clang-format off
-  e.dpadUp = e.dpadRight = e.dpadDown = e.dpadLeft = false;
+  // Byte 13: A, B, -, X, Y, -, LB, RB. Byte 14: -, -, view, menu, xbox, L3, R3. Byte 15: share.
   uint8_t byte12 = payload[12];
-  switch (byte12) {
-    case 1: e.dpadUp = true; break;
-    case 2: e.dpadUp = e.dpadRight = true; break;
-    case 3: e.dpadRight = true; break;
-    case 4: e.dpadRight = e.dpadDown = true; break;
-    case 5: e.dpadDown = true; break;
-    case 6: e.dpadDown = e.dpadLeft = true; break;
-    case 7: e.dpadLeft = true; break;
-    case 8: e.dpadLeft = e.dpadUp = true; break;
-    default: break;
-  }
-  // clang-format on
-
   uint8_t byte13 = payload[13];
-  e.buttonA = decodeButton(byte13, 0);
-  e.buttonB = decodeButton(byte13, 1);
-  e.buttonX = decodeButton(byte13, 3);
-  e.buttonY = decodeButton(byte13, 4);
-  e.leftBumper = decodeButton(byte13, 6);
-  e.rightBumper = decodeButton(byte13, 7);
-
-  uint8_t byte14 = payload[14];
-  e.view = decodeButton(byte14, 2);
-  e.menu = decodeButton(byte14, 3);
-  e.xbox = decodeButton(byte14, 4);
-  e.leftStickButton = decodeButton(byte14, 5);
-  e.rightStickButton = decodeButton(byte14, 6);
-
-  uint8_t byte15 = payload[15];
-  e.share = decodeButton(byte15, 0);
+  uint16_t buttons = (byte13 & 0x03) | ((byte13 >> 1) & 0x0c) | ((byte13 >> 2) & 0x30);
+  buttons |= (payload[14] << 4) & 0x07c0;
+  buttons |= (payload[15] & 0x01) << 11;
+  buttons |= byte12 < sizeof(dpadButtons) / sizeof(dpadButtons[0]) ? dpadButtons[byte12] : 0;
+  e.setButtons(buttons);
 
   return controlsPayloadLen;
 }
@@ -45,6 +45,13 @@
 #include <SPI.h>
 #endif 
 
+#ifdef U8X8_HAVE_ESP32_DMA_SPI
+#include <string.h>
+#include <driver/spi_master.h>
+#include <driver/gpio.h>
+#include <esp_heap_caps.h>
+#endif
+
 #ifdef U8X8_HAVE_HW_I2C
 #  ifdef U8X8_HAVE_HW_I2C_TEENSY3
 #    include <i2c_t3.h>
@@ -1008,6 +1015,218 @@ extern "C" uint8_t u8x8_byte_arduino_hw_spi(u8x8_t *u8x8, uint8_t msg, uint8_t a
 }
 
 
+/*=============================================*/
+/*=== 4 WIRE HARDWARE SPI, ESP32 DMA QUEUE ===*/
+
+/*
+  Same wiring as u8x8_byte_arduino_hw_spi, but the bytes are queued as DMA
+  transactions of the ESP-IDF SPI master driver and the call returns before
+  they are on the wire. DC is switched by the driver right before each
+  transaction starts, so commands and data stay in order without blocking.
+
+  Sends that point into a range given to u8x8_byte_esp32_dma_spi_zero_copy()
+  (the frame buffers) are not copied: the bytes must not change until the
+  fence taken after them passed, see u8x8_byte_esp32_dma_spi_fence(). Everything
+  else (commands, tiles on the stack) is copied into a small per transaction
+  buffer.
+*/
+
+#if defined(U8X8_HAVE_ESP32_DMA_SPI)
+
+#define U8X8_ESP32_DMA_SPI_QUEUE_SIZE 24	/* transactions in flight, a full 128x64 frame needs 16 */
+#define U8X8_ESP32_DMA_SPI_COPY_SIZE 32		/* bytes of a copied transaction */
+#define U8X8_ESP32_DMA_SPI_ZERO_COPY_RANGES 2	/* e.g. the two buffers of a double buffered frame */
+
+#if defined(CONFIG_IDF_TARGET_ESP32)
+#define U8X8_ESP32_DMA_SPI_HOST SPI3_HOST	/* VSPI, the default SPI of the Arduino core */
+#else
+#define U8X8_ESP32_DMA_SPI_HOST SPI2_HOST
+#endif
+
+static spi_device_handle_t u8x8_esp32_dma_spi_device = NULL;
+static spi_transaction_t u8x8_esp32_dma_spi_trans[U8X8_ESP32_DMA_SPI_QUEUE_SIZE];
+static uint8_t *u8x8_esp32_dma_spi_copy_buf = NULL;
+static uint8_t u8x8_esp32_dma_spi_next = 0;	/* next free transaction */
+static uint32_t u8x8_esp32_dma_spi_queued = 0;	/* transactions queued since init */
+static uint32_t u8x8_esp32_dma_spi_done = 0;	/* transactions collected since init */
+static uint8_t u8x8_esp32_dma_spi_fill = 0;	/* copied bytes waiting in the next transaction */
+static uint8_t u8x8_esp32_dma_spi_dc = 0;
+static uint8_t u8x8_esp32_dma_spi_dc_pin = U8X8_PIN_NONE;
+static const uint8_t *u8x8_esp32_dma_spi_zc_begin[U8X8_ESP32_DMA_SPI_ZERO_COPY_RANGES];
+static const uint8_t *u8x8_esp32_dma_spi_zc_end[U8X8_ESP32_DMA_SPI_ZERO_COPY_RANGES];
+static uint8_t u8x8_esp32_dma_spi_zc_count = 0;
+
+static void IRAM_ATTR u8x8_esp32_dma_spi_pre_cb(spi_transaction_t *t)
+{
+  uint32_t dc = (uint32_t)(uintptr_t)t->user;
+  if ( (dc >> 1) != U8X8_PIN_NONE )
+    gpio_set_level((gpio_num_t)(dc >> 1), dc & 1);
+}
+
+/* collect one finished transaction, transactions complete in order */
+static void u8x8_esp32_dma_spi_collect(void)
+{
+  spi_transaction_t *done;
+  spi_device_get_trans_result(u8x8_esp32_dma_spi_device, &done, portMAX_DELAY);
+  u8x8_esp32_dma_spi_done++;
+}
+
+/* make sure the next transaction is free */
+static void u8x8_esp32_dma_spi_reserve(void)
+{
+  if ( u8x8_esp32_dma_spi_queued - u8x8_esp32_dma_spi_done >= U8X8_ESP32_DMA_SPI_QUEUE_SIZE )
+    u8x8_esp32_dma_spi_collect();
+}
+
+static uint8_t u8x8_esp32_dma_spi_is_zero_copy(const uint8_t *data, uint8_t len)
+{
+  uint8_t i;
+  for( i = 0; i < u8x8_esp32_dma_spi_zc_count; i++ )
+    if ( data >= u8x8_esp32_dma_spi_zc_begin[i] && data + len <= u8x8_esp32_dma_spi_zc_end[i] )
+      return 1;
+  return 0;
+}
+
+static void u8x8_esp32_dma_spi_queue(const uint8_t *data, size_t len)
+{
+  spi_transaction_t *t = u8x8_esp32_dma_spi_trans + u8x8_esp32_dma_spi_next;
+  memset(t, 0, sizeof(spi_transaction_t));
+  t->length = len*8;
+  t->tx_buffer = data;
+  t->user = (void *)(uintptr_t)((u8x8_esp32_dma_spi_dc_pin << 1) | u8x8_esp32_dma_spi_dc);
+  spi_device_queue_trans(u8x8_esp32_dma_spi_device, t, portMAX_DELAY);
+  u8x8_esp32_dma_spi_queued++;
+  u8x8_esp32_dma_spi_next = (u8x8_esp32_dma_spi_next + 1) % U8X8_ESP32_DMA_SPI_QUEUE_SIZE;
+}
+
+/* queue the copied bytes collected so far */
+static void u8x8_esp32_dma_spi_flush(void)
+{
+  if ( u8x8_esp32_dma_spi_fill == 0 )
+    return;
+  u8x8_esp32_dma_spi_queue(u8x8_esp32_dma_spi_copy_buf + u8x8_esp32_dma_spi_next*U8X8_ESP32_DMA_SPI_COPY_SIZE, u8x8_esp32_dma_spi_fill);
+  u8x8_esp32_dma_spi_fill = 0;
+}
+
+extern "C" uint8_t u8x8_byte_esp32_dma_spi_zero_copy(const uint8_t *buf, size_t size)
+{
+  if ( u8x8_esp32_dma_spi_zc_count >= U8X8_ESP32_DMA_SPI_ZERO_COPY_RANGES )
+    return 0;
+  u8x8_esp32_dma_spi_zc_begin[u8x8_esp32_dma_spi_zc_count] = buf;
+  u8x8_esp32_dma_spi_zc_end[u8x8_esp32_dma_spi_zc_count] = buf + size;
+  u8x8_esp32_dma_spi_zc_count++;
+  return 1;
+}
+
+extern "C" uint32_t u8x8_byte_esp32_dma_spi_fence(void)
+{
+  if ( u8x8_esp32_dma_spi_device != NULL )
+    u8x8_esp32_dma_spi_flush();
+  return u8x8_esp32_dma_spi_queued;
+}
+
+extern "C" void u8x8_byte_esp32_dma_spi_wait_fence(uint32_t fence)
+{
+  /* wrap around safe: wait while fewer than fence transactions are done */
+  while( (int32_t)(u8x8_esp32_dma_spi_done - fence) < 0 )
+    u8x8_esp32_dma_spi_collect();
+}
+
+extern "C" void u8x8_byte_esp32_dma_spi_wait(void)
+{
+  u8x8_byte_esp32_dma_spi_wait_fence(u8x8_byte_esp32_dma_spi_fence());
+}
+
+extern "C" uint8_t u8x8_byte_esp32_dma_spi(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
+{
+  const uint8_t *data;
+  uint8_t n;
+
+  switch(msg)
+  {
+    case U8X8_MSG_BYTE_SEND:
+      data = (const uint8_t *)arg_ptr;
+      if ( u8x8_esp32_dma_spi_is_zero_copy(data, arg_int) )
+      {
+	u8x8_esp32_dma_spi_flush();
+	u8x8_esp32_dma_spi_reserve();
+	u8x8_esp32_dma_spi_queue(data, arg_int);
+	break;
+      }
+      while( arg_int > 0 )
+      {
+	if ( u8x8_esp32_dma_spi_fill == 0 )
+	  u8x8_esp32_dma_spi_reserve();
+	n = U8X8_ESP32_DMA_SPI_COPY_SIZE - u8x8_esp32_dma_spi_fill;
+	if ( n > arg_int )
+	  n = arg_int;
+	memcpy(u8x8_esp32_dma_spi_copy_buf + u8x8_esp32_dma_spi_next*U8X8_ESP32_DMA_SPI_COPY_SIZE + u8x8_esp32_dma_spi_fill, data, n);
+	u8x8_esp32_dma_spi_fill += n;
+	data += n;
+	arg_int -= n;
+	if ( u8x8_esp32_dma_spi_fill == U8X8_ESP32_DMA_SPI_COPY_SIZE )
+	  u8x8_esp32_dma_spi_flush();
+      }
+      break;
+
+    case U8X8_MSG_BYTE_INIT:
+      if ( u8x8->bus_clock == 0 ) 	/* issue 769 */
+	u8x8->bus_clock = u8x8->display_info->sck_clock_hz;
+      if ( u8x8_esp32_dma_spi_device == NULL )
+      {
+	spi_bus_config_t bus;
+	spi_device_interface_config_t dev;
+
+	memset(&bus, 0, sizeof(bus));
+	bus.sclk_io_num = u8x8->pins[U8X8_PIN_SPI_CLOCK] != U8X8_PIN_NONE ? u8x8->pins[U8X8_PIN_SPI_CLOCK] : SCK;
+	bus.mosi_io_num = u8x8->pins[U8X8_PIN_SPI_DATA] != U8X8_PIN_NONE ? u8x8->pins[U8X8_PIN_SPI_DATA] : MOSI;
+	bus.miso_io_num = -1;
+	bus.quadwp_io_num = -1;
+	bus.quadhd_io_num = -1;
+	bus.max_transfer_sz = 256;	/* SendData never sends more than 255 bytes */
+
+	memset(&dev, 0, sizeof(dev));
+	dev.clock_speed_hz = u8x8->bus_clock;
+	dev.mode = u8x8->display_info->spi_mode;
+	dev.spics_io_num = u8x8->pins[U8X8_PIN_CS] != U8X8_PIN_NONE ? u8x8->pins[U8X8_PIN_CS] : -1;
+	dev.queue_size = U8X8_ESP32_DMA_SPI_QUEUE_SIZE;
+	dev.pre_cb = u8x8_esp32_dma_spi_pre_cb;
+
+	u8x8_esp32_dma_spi_copy_buf = (uint8_t *)heap_caps_malloc(U8X8_ESP32_DMA_SPI_QUEUE_SIZE*U8X8_ESP32_DMA_SPI_COPY_SIZE, MALLOC_CAP_DMA);
+	if ( u8x8_esp32_dma_spi_copy_buf == NULL )
+	  return 0;
+	if ( spi_bus_initialize(U8X8_ESP32_DMA_SPI_HOST, &bus, SPI_DMA_CH_AUTO) != ESP_OK )
+	  return 0;
+	if ( spi_bus_add_device(U8X8_ESP32_DMA_SPI_HOST, &dev, &u8x8_esp32_dma_spi_device) != ESP_OK )
+	  return 0;
+      }
+      u8x8_esp32_dma_spi_dc_pin = u8x8->pins[U8X8_PIN_DC];
+      break;
+
+    case U8X8_MSG_BYTE_SET_DC:
+      /* the driver switches DC before the transaction, bytes of the other level go into a new one */
+      if ( arg_int != u8x8_esp32_dma_spi_dc )
+	u8x8_esp32_dma_spi_flush();
+      u8x8_esp32_dma_spi_dc = arg_int;
+      break;
+
+    case U8X8_MSG_BYTE_START_TRANSFER:
+      /* chip select is driven by the SPI master driver */
+      break;
+
+    case U8X8_MSG_BYTE_END_TRANSFER:
+      u8x8_esp32_dma_spi_flush();
+      break;
+
+    default:
+      return 0;
+  }
+  return 1;
+}
+
+#endif	/* U8X8_HAVE_ESP32_DMA_SPI */
+
+
 /* issue #244 */
 extern "C" uint8_t u8x8_byte_arduino_2nd_hw_spi(U8X8_UNUSED u8x8_t *u8x8, U8X8_UNUSED uint8_t msg, U8X8_UNUSED uint8_t arg_int, U8X8_UNUSED void *arg_ptr)
 {
@@ -140,6 +140,11 @@
 #endif
 #endif /* U8X8_HAVE_HW_I2C */
 
+/* define U8X8_HAVE_ESP32_DMA_SPI for the asynchronous DMA byte callback of the ESP32 */
+#if defined(ESP_PLATFORM) && defined(U8X8_HAVE_HW_SPI) && defined(U8X8_USE_PINS)
+#define U8X8_HAVE_ESP32_DMA_SPI
+#endif
+
 /* define U8X8_HAVE_2ND_HW_SPI if the board has a second wire interface*/
 /* As of writing this, I did not found any official board which supports this */
 /* so this is not tested (May 2017), issue #224 */
@@ -161,6 +166,18 @@ extern "C" uint8_t u8x8_byte_arduino_3wire_sw_spi(u8x8_t *u8x8, uint8_t msg, uin
 extern "C" uint8_t u8x8_byte_arduino_3wire_hw_spi(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr);
 extern "C" uint8_t u8x8_byte_arduino_hw_spi(u8x8_t *u8g2, uint8_t msg, uint8_t arg_int, void *arg_ptr);
 extern "C" uint8_t u8x8_byte_arduino_2nd_hw_spi(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr); /* #244 */
+#ifdef U8X8_HAVE_ESP32_DMA_SPI
+/* asynchronous 4 wire HW SPI through the DMA queue of the ESP-IDF SPI master driver */
+extern "C" uint8_t u8x8_byte_esp32_dma_spi(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr);
+/* sends from [buf, buf+size) are not copied, they must stay unchanged until their fence passed, returns 0 if no range is left */
+extern "C" uint8_t u8x8_byte_esp32_dma_spi_zero_copy(const uint8_t *buf, size_t size);
+/* fence behind every byte sent so far */
+extern "C" uint32_t u8x8_byte_esp32_dma_spi_fence(void);
+/* block until every byte sent before the fence is on the wire */
+extern "C" void u8x8_byte_esp32_dma_spi_wait_fence(uint32_t fence);
+/* block until every queued byte is on the wire */
+extern "C" void u8x8_byte_esp32_dma_spi_wait(void);
+#endif
 extern "C" uint8_t u8x8_byte_arduino_sw_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr);
 extern "C" uint8_t u8x8_byte_arduino_hw_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr);
 extern "C" uint8_t u8x8_byte_arduino_2nd_hw_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr);
@@ -26,11 +26,13 @@
 #define BMA250_REG_POWER_MODE     0x11
 #define BMA250_REG_BGW_SOFTRESET  0x14
 #define BMA250_REG_INT_EN_0       0x16
+#define BMA250_REG_INT_EN_1       0x17
 #define BMA250_REG_INT_MAP_0      0x19
 #define BMA250_REG_INT_MAP_1      0x1A
 #define BMA250_REG_INT_SRC        0x1E
 #define BMA250_REG_INT_OUT_CTRL   0x20
 #define BMA250_REG_INT_RST_LATCH  0x21
+#define BMA250_RESET_INT          B10000000 // reset_int bit of INT_RST_LATCH, clears the latched interrupts
 #define BMA250_REG_INT_0          0x22
 #define BMA250_REG_INT_1          0x23
 #define BMA250_REG_INT_2          0x24
@@ -57,6 +59,33 @@ void BMA250_INIT_EVENT(void){
   FLAG_DoubleTap = true;
 }
 
+// Sensor owning the sampling task, the trigger interrupts have no parameter
+static BMA250 *samplingSensor = NULL;
+static TaskHandle_t samplingTaskHandle = NULL;
+static volatile uint32_t samplingTriggerUs = 0;
+
+/**
+ * @brief Timer or data ready interrupt, wakes the sampling task.
+ */
+static void IRAM_ATTR onSamplingTrigger(void){
+  BaseType_t higherPriorityTaskWoken = pdFALSE;
+  samplingTriggerUs = micros();
+  vTaskNotifyGiveFromISR(samplingTaskHandle, &higherPriorityTaskWoken);
+  portYIELD_FROM_ISR(higherPriorityTaskWoken);
+}
+
+/**
+ * @brief FreeRTOS task reading one sample per trigger into the sample ring.
+ * @param param Pointer to BMA250 object.
+ */
+static void BMA250SamplingTask(void* param){
+  BMA250 *obj = (BMA250*) param;
+  while(1){
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    obj->acquireSample(samplingTriggerUs);
+  }
+}
+
 /**
  * @brief FreeRTOS task to handle double tap events and call user actions.
  * @param param Pointer to BMA250 object.
@@ -65,6 +94,9 @@ void DoubleTapTask(void* param){
   BMA250 *obj = (BMA250*) param;
   Serial.println("BMA250 DoupleTap Task Started! ");
   uint8_t intrupt_direction = 0;
+  BMA250Reader tapReader;
+  bool tapReaderCreated = false;
+  BMA250Sample sample;
   while(1){
     if (FLAG_DoubleTap){
       FLAG_DoubleTap = false;
@@ -125,7 +157,18 @@ void DoubleTapTask(void* param){
           break;
       }
     }
-    intrupt_direction = obj->readRegister(BMA250_REG_INT_STATUS_2);
+    // While sampling, the tap direction comes with every sample, no extra I2C read
+    if (obj->isSampling()){
+      if (!tapReaderCreated){
+        tapReader = obj->createReader();
+        tapReaderCreated = true;
+      }
+      if (tapReader.readLatest(&sample)){
+        intrupt_direction = sample.tapStatus;
+      }
+    }else{
+      intrupt_direction = obj->readRegister(BMA250_REG_INT_STATUS_2);
+    }
     delay(50);
   }
 }
@@ -154,6 +197,27 @@ uint8_t BMA250::readRegister(uint8_t RegAddr){
   return 0xFF;  // Return invalid value if read fails
 }
 
+/**
+ * @brief Read consecutive BMA250 registers in a single I2C transaction.
+ *        The register address auto-increments on the sensor.
+ * @param RegAddr Address of the first register.
+ * @param buffer Buffer receiving the values.
+ * @param length Number of registers to read.
+ * @return True if all registers were read.
+ */
+bool BMA250::readRegisters(uint8_t RegAddr, uint8_t *buffer, uint8_t length){
+  Wire.beginTransmission(BMA250_I2C_ADDR);
+  Wire.write(RegAddr);
+  Wire.endTransmission(false);
+  if (Wire.requestFrom(BMA250_I2C_ADDR, length) != length) {
+    return false;
+  }
+  for (uint8_t i = 0; i < length; i++) {
+    buffer[i] = Wire.read();
+  }
+  return true;
+}
+
 /**
  * @brief Write a single byte to a BMA250 register.
  * @param RegAddr Register address to write to.
@@ -174,17 +238,17 @@ void BMA250::setBandwidth(BMA250Bandwidth bw){
   // Register 0X10 (PMU_BW)
   // BITs   7:5 reserved, 4:0 bw<4:0>
   writeRegister(BMA250_REG_BW,(uint8_t)bw);
+  Bandwidth = bw;
+  // Keep the sampling timer at the new output data rate
+  if (SamplingTimer != NULL){
+    timerAlarm(SamplingTimer, getSamplePeriodUs() * (BMA250_SAMPLING_TIMER_FREQ / 1000000), true, 0);
+  }
 }
 
 /**
- * @brief Read a 10-bit signed value from the specified axis registers.
- * @param msbReg Register address for MSB.
- * @param lsbReg Register address for LSB.
- * @return Signed 10-bit raw value.
+ * @brief Combine the LSB and MSB registers of an axis into a signed 10-bit value.
  */
-int16_t BMA250::readAxis(uint8_t msbReg, uint8_t lsbReg) {
-  uint8_t lsb = readRegister(lsbReg); // The LSB must always be read first to keep the integrity of data
-  uint8_t msb = readRegister(msbReg);
+static int16_t toAxisValue(uint8_t lsb, uint8_t msb) {
   // Combine MSB and LSB (10-bit value)
   int16_t raw = ((int16_t)msb << 2) | (lsb >> 6);
   // Convert to signed 10-bit
@@ -192,14 +256,72 @@ int16_t BMA250::readAxis(uint8_t msbReg, uint8_t lsbReg) {
   return raw;
 }
 
+/**
+ * @brief Read a 10-bit signed value from the specified axis registers.
+ * @param lsbReg Register address for LSB, the MSB is the next register.
+ * @return Signed 10-bit raw value.
+ */
+int16_t BMA250::readAxis(uint8_t lsbReg) {
+  uint8_t data[2] = {0xFF, 0xFF};
+  // The LSB must always be read first to keep the integrity of data, the burst reads it first
+  readRegisters(lsbReg, data, 2);
+  return toAxisValue(data[0], data[1]);
+}
+
+/**
+ * @brief Read the three axes in a single 6-byte burst (0x02..0x07).
+ *        The sensor locks the MSBs when the LSB is read, so the axes stay coherent.
+ * @param sample Raw signed 10-bit values of X, Y and Z.
+ * @return True if the sample was read.
+ */
+bool BMA250::readSample(int16_t sample[3]){
+  uint8_t data[6];
+  if (!readRegisters(BMA250_REG_ACC_X_LSB, data, 6)) {
+    return false;
+  }
+  sample[BMA250_AXIS_X] = toAxisValue(data[0], data[1]);
+  sample[BMA250_AXIS_Y] = toAxisValue(data[2], data[3]);
+  sample[BMA250_AXIS_Z] = toAxisValue(data[4], data[5]);
+  return true;
+}
+
+/**
+ * @brief Read the three axes in g from one sample.
+ * @return True if the sample was read.
+ */
+bool BMA250::readAll(float *x, float *y, float *z){
+  int16_t sample[3];
+  if (!readSample(sample)) {
+    return false;
+  }
+  *x = sample[BMA250_AXIS_X] / (float)BMA250_LSB_PER_G;
+  *y = sample[BMA250_AXIS_Y] / (float)BMA250_LSB_PER_G;
+  *z = sample[BMA250_AXIS_Z] / (float)BMA250_LSB_PER_G;
+  return true;
+}
+
+/**
+ * @brief Read pitch and roll from one sample.
+ * @return True if the sample was read.
+ */
+bool BMA250::readAttitude(float *pitch, float *roll){
+  int16_t sample[3];
+  if (!readSample(sample)) {
+    return false;
+  }
+  *pitch = getPitchAngle(sample);
+  *roll = getRollAngle(sample);
+  return true;
+}
+
 /**
  * @brief Read acceleration in g for the X axis.
  * @return Acceleration in g.
  */
 float BMA250::readXaxis(void){
-  int16_t x = readAxis(0x03, 0x02); // X axis
+  int16_t x = readAxis(BMA250_REG_ACC_X_LSB); // X axis
   // Convert raw to g-force (assuming ±2g range, 256 LSB/g)
-  float g = x / 256.0;
+  float g = x / (float)BMA250_LSB_PER_G;
   return g;
 }
 
@@ -208,9 +330,9 @@ float BMA250::readXaxis(void){
  * @return Acceleration in g.
  */
 float BMA250::readYaxis(void){
-  int16_t y = readAxis(0x05, 0x04); // Y axis
+  int16_t y = readAxis(BMA250_REG_ACC_Y_LSB); // Y axis
   // Convert raw to g-force (assuming ±2g range, 256 LSB/g)
-  float g = y / 256.0;
+  float g = y / (float)BMA250_LSB_PER_G;
   return g;
 }
 
@@ -219,9 +341,9 @@ float BMA250::readYaxis(void){
  * @return Acceleration in g.
  */
 float BMA250::readZaxis(void){
-  int16_t z = readAxis(0x07, 0x06); // Z axis
+  int16_t z = readAxis(BMA250_REG_ACC_Z_LSB); // Z axis
   // Convert raw to g-force (assuming ±2g range, 256 LSB/g)
-  float g = z / 256.0;
+  float g = z / (float)BMA250_LSB_PER_G;
   return g;
 }
 
@@ -310,32 +432,131 @@ void BMA250::initialize(void) {
   
 
 
+/*
+    Output data rate of the sensor is twice its bandwidth
+    */
+uint32_t BMA250::getSamplePeriodUs(void){
+  switch (Bandwidth) {
+    case BW_7_81HZ:  return 64000;
+    case BW_15_63HZ: return 32000;
+    case BW_31_25HZ: return 16000;
+    case BW_62_5HZ:  return 8000;
+    case BW_125HZ:   return 4000;
+    case BW_250HZ:   return 2000;
+    case BW_500HZ:   return 1000;
+    case BW_1000HZ:
+    default:         return 500;
+  }
+}
+
+/**
+ * @brief Start the sampling task, woken by a hardware timer or the data ready interrupt.
+ * @param source What wakes the task.
+ * @return True if sampling runs, only one sensor can sample.
+ */
+bool BMA250::startSampling(BMA250SamplingSource source){
+  if (samplingSensor != NULL){
+    return samplingSensor == this;
+  }
+  samplingSensor = this;
+  SamplingSource = source;
+  xTaskCreate(BMA250SamplingTask, "BMA250 Sampling", BMA250_SAMPLING_STACK_SIZE, this, BMA250_SAMPLING_PRIORITY, &samplingTaskHandle);
+
+  if (source == SAMPLE_ON_DATA_READY){
+    // Data ready takes over INT1, the double tap is then taken from the sample status.
+    // It stays latched until a sample saw it, a 1 mS latch mostly falls between two samples.
+    detachInterrupt(BMA250_INT_PIN);
+    attachInterrupt(BMA250_INT_PIN, onSamplingTrigger, RISING);
+    writeRegister(BMA250_REG_INT_MAP_0, B00000000); // Double tap off INT1, a latched tap would hold the line
+    writeRegister(BMA250_REG_INT_RST_LATCH, INT_MODE_LATCHED);
+    writeRegister(BMA250_REG_INT_MAP_1, B00000001); // Data ready on INT1
+    writeRegister(BMA250_REG_INT_EN_1, B00010000);  // Enable data ready interrupt
+  }else{
+    SamplingTimer = timerBegin(BMA250_SAMPLING_TIMER_FREQ);
+    timerAttachInterrupt(SamplingTimer, &onSamplingTrigger);
+    timerAlarm(SamplingTimer, getSamplePeriodUs() * (BMA250_SAMPLING_TIMER_FREQ / 1000000), true, 0);
+  }
+  return true;
+}
+
+bool BMA250::isSampling(void){
+  return samplingSensor == this;
+}
+
+bool BMA250::addSampleListener(TaskHandle_t task){
+  uint8_t listenerCount = SampleListenerCount.load(std::memory_order_relaxed);
+  if (listenerCount >= BMA250_MAX_SAMPLE_LISTENERS){
+    return false;
+  }
+  // Written before the count, the sampling task only reads entries below the count
+  SampleListeners[listenerCount] = task;
+  SampleListenerCount.store(listenerCount + 1, std::memory_order_release);
+  return true;
+}
+
+BMA250Reader BMA250::createReader(void){
+  return BMA250Reader(&Samples);
+}
+
+/**
+ * @brief Read acceleration, temperature and interrupt status in one 10-byte burst (0x02..0x0B).
+ * @param timeUs Time stamp of the sample.
+ */
+void BMA250::acquireSample(uint32_t timeUs){
+  uint8_t data[10];
+  if (!readRegisters(BMA250_REG_ACC_X_LSB, data, 10)) {
+    return;
+  }
+  BMA250Sample sample;
+  sample.timeUs = timeUs;
+  sample.axis[BMA250_AXIS_X] = toAxisValue(data[0], data[1]);
+  sample.axis[BMA250_AXIS_Y] = toAxisValue(data[2], data[3]);
+  sample.axis[BMA250_AXIS_Z] = toAxisValue(data[4], data[5]);
+  sample.temperature = (int8_t)data[6];
+  sample.interruptStatus = data[BMA250_REG_INT_STATUS_0 - BMA250_REG_ACC_X_LSB];
+  sample.tapStatus = data[BMA250_REG_INT_STATUS_2 - BMA250_REG_ACC_X_LSB];
+  Samples.push(sample);
+  uint8_t listenerCount = SampleListenerCount.load(std::memory_order_acquire);
+  for (uint8_t i = 0; i < listenerCount; i++){
+    xTaskNotifyGive(SampleListeners[i]);
+  }
+
+  if (SamplingSource == SAMPLE_ON_DATA_READY){
+    // The interrupt line no longer tells taps apart, raise the flag on the latched d_tap_int
+    // and reset the latch for the next tap
+    if ((sample.interruptStatus & B00010000) != 0){
+      FLAG_DoubleTap = true;
+      writeRegister(BMA250_REG_INT_RST_LATCH, BMA250_RESET_INT | INT_MODE_LATCHED);
+    }
+  }
+}
+
 /**
  * @brief Get the angle in degrees between the X and Y axes.
  * @return Angle in degrees.
  */
 float BMA250::getAngleXY(void){
-  float x = readXaxis();
-  float y = readYaxis();
-  return atan2(y, x) * 180.0 / PI;
+  int16_t sample[3] = {0, 0, 0};
+  readSample(sample);
+  return atan2(sample[BMA250_AXIS_Y], sample[BMA250_AXIS_X]) * 180.0 / PI;
 }
 /**
  * @brief Get the angle in degrees between the X and Z axes.
  * @return Angle in degrees.
  */
 float BMA250::getAngleXZ(void){
-  float x = readXaxis();
-  float z = readZaxis();
-  return atan2(z, x) * 180.0 / PI;
+  int16_t sample[3] = {0, 0, 0};
+  readSample(sample);
+  return atan2(sample[BMA250_AXIS_Z], sample[BMA250_AXIS_X]) * 180.0 / PI;
 }
 /**
  * @brief Get the angle in degrees between the Y and Z axes.
  * @return Angle in degrees.
  */
 float BMA250::getAngleYZ(void){
-  float y = readYaxis();
-  float z = readZaxis();
-  return atan2(z, y) * 180.0 / PI;
+  int16_t sample[3] = {0, 0, 0};
+  readSample(sample);
+  return atan2(sample[BMA250_AXIS_Z], sample[BMA250_AXIS_Y]) * 180.0 / PI;
 }
 
 
@@ -343,10 +564,18 @@ float BMA250::getPitchAngle(void){
   return getAngleYZ() - 90;
 }
 
+float BMA250::getPitchAngle(const int16_t sample[3]){
+  return atan2(sample[BMA250_AXIS_Z], sample[BMA250_AXIS_Y]) * 180.0 / PI - 90;
+}
+
 float BMA250::getRollAngle(void){
   return getAngleXZ() - 90;
   }
 
+float BMA250::getRollAngle(const int16_t sample[3]){
+  return atan2(sample[BMA250_AXIS_Z], sample[BMA250_AXIS_X]) * 180.0 / PI - 90;
+}
+
 float BMA250::getTemperature(void){
   // Temperature register is at 0x08, value in degrees Celsius = (value * 0.5) + 23
   uint8_t temp_raw = readRegister(0x08);
@@ -3,10 +3,29 @@
 
 #include <Arduino.h>
 #include <Wire.h>
+#include <RTOS.h>
+#include "chiko_sample_ring.h"
 
 
 
 #define BMA250_INT_PIN            32
+#define BMA250_LSB_PER_G          256   // Sensitivity in the ±2g range
+
+/*
+    Sampling task
+    Reads the sensor into the sample ring at the output data rate of the
+    configured bandwidth. It runs above the joint scheduler, a sample read is
+    a single short I2C burst.
+*/
+#define BMA250_SAMPLING_PRIORITY      5
+#define BMA250_SAMPLING_STACK_SIZE    3072
+#define BMA250_SAMPLING_TIMER_FREQ    1000000
+#define BMA250_MAX_SAMPLE_LISTENERS   4   // Tasks notified on every new sample
+
+// Axis index in a sample
+#define BMA250_AXIS_X             0
+#define BMA250_AXIS_Y             1
+#define BMA250_AXIS_Z             2
 
 // Enum definitions for BMA250 configuration and events
 
@@ -70,6 +89,15 @@ enum BMA250RstLatch {
   INT_MODE_LATCHED = 0x0F // Latched mode
 };
 
+/**
+ * @enum BMA250SamplingSource
+ * @brief What wakes the sampling task.
+ */
+enum BMA250SamplingSource {
+  SAMPLE_ON_TIMER,      // Hardware timer at the output data rate
+  SAMPLE_ON_DATA_READY  // Data ready interrupt of the sensor on BMA250_INT_PIN
+};
+
 /**
  * @enum TapFace
  * @brief Faces of the sensor for tap detection.
@@ -94,12 +122,18 @@ enum TapFace {
 class BMA250{
   private:
     /**
-     * @brief Read a signed 16-bit value from two registers (MSB and LSB) for an axis.
-     * @param msbReg Register address for the most significant byte.
-     * @param lsbReg Register address for the least significant byte.
-     * @return The combined signed 16-bit axis value.
+     * @brief Read the signed 10-bit value of an axis, LSB and MSB in one transaction.
+     * @param lsbReg Register address of the least significant byte, the MSB follows it.
+     * @return The signed axis value.
      */
-    int16_t readAxis(uint8_t msbReg, uint8_t lsbReg);
+    int16_t readAxis(uint8_t lsbReg);
+
+    BMA250Bandwidth Bandwidth = BW_125HZ;       // Configured bandwidth
+    BMA250SampleRing Samples;                   // Samples read by the sampling task
+    hw_timer_t *SamplingTimer = NULL;           // Timer waking the sampling task
+    BMA250SamplingSource SamplingSource = SAMPLE_ON_TIMER;
+    TaskHandle_t SampleListeners[BMA250_MAX_SAMPLE_LISTENERS];
+    std::atomic<uint8_t> SampleListenerCount{0};
     
   public:
     /**
@@ -127,6 +161,39 @@ class BMA250{
      */
     void writeRegister(uint8_t RegAddr, uint8_t value);
 
+    /**
+     * @brief Read consecutive registers from the BMA250 in a single transaction.
+     * @param RegAddr Address of the first register.
+     * @param buffer Buffer receiving the values.
+     * @param length Number of registers to read.
+     * @return True if all registers were read.
+     */
+    bool readRegisters(uint8_t RegAddr, uint8_t *buffer, uint8_t length);
+
+    /**
+     * @brief Read the three axes in one 6-byte burst, so they belong to the same sample.
+     * @param sample Raw signed 10-bit values of X, Y and Z (see BMA250_AXIS_X...).
+     * @return True if the sample was read.
+     */
+    bool readSample(int16_t sample[3]);
+
+    /**
+     * @brief Read the three axes in one burst.
+     * @param x Acceleration on the X axis in g.
+     * @param y Acceleration on the Y axis in g.
+     * @param z Acceleration on the Z axis in g.
+     * @return True if the sample was read.
+     */
+    bool readAll(float *x, float *y, float *z);
+
+    /**
+     * @brief Read pitch and roll from one sample.
+     * @param pitch Pitch angle in degrees.
+     * @param roll Roll angle in degrees.
+     * @return True if the sample was read.
+     */
+    bool readAttitude(float *pitch, float *roll);
+
     /**
      * @brief Read the X-axis acceleration value.
      * @return Acceleration in g or raw units (implementation dependent).
@@ -194,12 +261,65 @@ class BMA250{
    */
   float getPitchAngle(void);
 
+  /**
+   * @brief Get the pitch angle of a sample read with readSample().
+   * @param sample Raw sample.
+   * @return Pitch angle in degrees.
+   */
+  static float getPitchAngle(const int16_t sample[3]);
+
   /**
    * @brief Get the roll angle of the sensor (rotation around X axis).
    * @return Roll angle in degrees.
    */
   float getRollAngle(void);
 
+  /**
+   * @brief Get the roll angle of a sample read with readSample().
+   * @param sample Raw sample.
+   * @return Roll angle in degrees.
+   */
+  static float getRollAngle(const int16_t sample[3]);
+
+  /**
+   * @brief Start the sampling task. Samples are read at the output data rate of the
+   *        bandwidth (twice the bandwidth) into a ring shared by all readers.
+   * @param source What wakes the task (default: hardware timer).
+   * @return True if sampling runs.
+   */
+  bool startSampling(BMA250SamplingSource source = SAMPLE_ON_TIMER);
+
+  /**
+   * @brief Check whether the sampling task runs.
+   */
+  bool isSampling(void);
+
+  /**
+   * @brief Create a reader of the sample stream, starting with the next sample.
+   *        Each consumer keeps its own reader.
+   */
+  BMA250Reader createReader(void);
+
+  /**
+   * @brief Notify a task (xTaskNotifyGive) after every new sample, so it can
+   *        block on ulTaskNotifyTake() instead of polling its reader.
+   * @param task The task to notify.
+   * @return False if BMA250_MAX_SAMPLE_LISTENERS tasks are already notified.
+   */
+  bool addSampleListener(TaskHandle_t task);
+
+  /**
+   * @brief Get the sampling period of the configured bandwidth.
+   * @return Period in uS.
+   */
+  uint32_t getSamplePeriodUs(void);
+
+  /**
+   * @brief Read one sample into the ring. Called by the sampling task.
+   * @param timeUs Time stamp of the sample.
+   */
+  void acquireSample(uint32_t timeUs);
+
   /**
    * @brief Get the temperature reading from the sensor (if supported).
    * @return Temperature in degrees Celsius.
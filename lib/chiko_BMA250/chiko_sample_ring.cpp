@@ -0,0 +1,87 @@
+#include "chiko_sample_ring.h"
+
+BMA250SampleRing::BMA250SampleRing() : Head(0) {
+  for (uint32_t i = 0; i < BMA250_SAMPLE_RING_SIZE; i++) {
+    SlotSequence[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+/*
+    Sample n is complete in its slot when the slot sequence is 2n+2
+    */
+void BMA250SampleRing::push(const BMA250Sample &sample) {
+  uint32_t index = Head.load(std::memory_order_relaxed);
+  uint32_t slot = index % BMA250_SAMPLE_RING_SIZE;
+  SlotSequence[slot].store(2 * index + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  Slots[slot] = sample;
+  SlotSequence[slot].store(2 * index + 2, std::memory_order_release);
+  Head.store(index + 1, std::memory_order_release);
+}
+
+bool BMA250SampleRing::read(uint32_t index, BMA250Sample *sample) const {
+  uint32_t slot = index % BMA250_SAMPLE_RING_SIZE;
+  uint32_t sequence = SlotSequence[slot].load(std::memory_order_acquire);
+  if (sequence != 2 * index + 2) {
+    return false;
+  }
+  *sample = Slots[slot];
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return SlotSequence[slot].load(std::memory_order_relaxed) == sequence;
+}
+
+uint32_t BMA250SampleRing::getHead(void) const {
+  return Head.load(std::memory_order_acquire);
+}
+
+BMA250Reader::BMA250Reader(const BMA250SampleRing *ring) {
+  Ring = ring;
+  // A new reader starts with the next sample
+  Cursor = ring->getHead();
+}
+
+bool BMA250Reader::read(BMA250Sample *sample) {
+  if (Ring == NULL) {
+    return false;
+  }
+  while (true) {
+    uint32_t head = Ring->getHead();
+    if (Cursor == head) {
+      return false;
+    }
+    if (head - Cursor > BMA250_SAMPLE_RING_SIZE) {
+      Dropped += head - BMA250_SAMPLE_RING_SIZE - Cursor;
+      Cursor = head - BMA250_SAMPLE_RING_SIZE;
+    }
+    if (Ring->read(Cursor, sample)) {
+      Cursor++;
+      return true;
+    }
+    // The slot was overwritten while it was copied, the reader is a full ring behind
+    Dropped++;
+    Cursor++;
+  }
+}
+
+bool BMA250Reader::readLatest(BMA250Sample *sample) {
+  if (Ring == NULL) {
+    return false;
+  }
+  uint32_t head = Ring->getHead();
+  if (Cursor == head) {
+    return false;
+  }
+  Cursor = head - 1;
+  return read(sample);
+}
+
+uint32_t BMA250Reader::available(void) const {
+  if (Ring == NULL) {
+    return 0;
+  }
+  return min(Ring->getHead() - Cursor, (uint32_t)BMA250_SAMPLE_RING_SIZE);
+}
+
+uint32_t BMA250Reader::getDropped(void) const {
+  return Dropped;
+}
@@ -0,0 +1,102 @@
+#ifndef __CHIKO_SAMPLE_RING__
+#define __CHIKO_SAMPLE_RING__
+
+#include <Arduino.h>
+#include <atomic>
+
+/*
+    Number of samples kept by the ring, a power of two. At 250 Hz the ring
+    holds the last quarter of a second.
+*/
+#define BMA250_SAMPLE_RING_SIZE   64
+
+/**
+ * @struct BMA250Sample
+ * @brief One timestamped raw sample of the BMA250.
+ */
+struct BMA250Sample {
+    uint32_t timeUs;          // Time of the acquisition [uS], micros() clock
+    int16_t axis[3];          // Raw signed 10-bit X, Y and Z (see BMA250_AXIS_X...)
+    int8_t temperature;       // Raw temperature, 0.5 C/LSB around 23 C
+    uint8_t interruptStatus;  // INT_STATUS_0 at the time of the sample
+    uint8_t tapStatus;        // INT_STATUS_2, direction of the last tap
+};
+
+/**
+ * @class BMA250SampleRing
+ * @brief Single-producer multi-consumer ring of samples, without locks.
+ *        Every slot is guarded by its own sequence number: the producer makes it
+ *        odd while writing, readers check it before and after copying the slot,
+ *        so a reader never blocks the producer and detects a slot overwritten
+ *        under it.
+ */
+class BMA250SampleRing{
+    private:
+        BMA250Sample Slots[BMA250_SAMPLE_RING_SIZE];
+        std::atomic<uint32_t> SlotSequence[BMA250_SAMPLE_RING_SIZE];
+        std::atomic<uint32_t> Head;  // Index of the next sample to be written
+
+    public:
+        BMA250SampleRing();
+
+        /**
+         * @brief Append a sample, overwriting the oldest one. Producer only.
+         */
+        void push(const BMA250Sample &sample);
+
+        /**
+         * @brief Copy the sample with the given index.
+         * @param index Index of the sample since the start of sampling.
+         * @param sample The copy.
+         * @return False if the sample is not written yet or was overwritten.
+         */
+        bool read(uint32_t index, BMA250Sample *sample) const;
+
+        /**
+         * @brief Get the index of the next sample to be written.
+         */
+        uint32_t getHead(void) const;
+};
+
+/**
+ * @class BMA250Reader
+ * @brief Cursor of one consumer in the sample ring. Each consumer owns its reader,
+ *        readers do not affect each other or the producer.
+ */
+class BMA250Reader{
+    private:
+        const BMA250SampleRing *Ring = NULL;
+        uint32_t Cursor = 0;
+        uint32_t Dropped = 0;
+
+    public:
+        BMA250Reader(void) {}
+        BMA250Reader(const BMA250SampleRing *ring);
+
+        /**
+         * @brief Get the oldest sample this reader has not seen yet.
+         *        If the reader fell more than a ring behind, the missed samples are skipped.
+         * @param sample The sample.
+         * @return False if there is no new sample.
+         */
+        bool read(BMA250Sample *sample);
+
+        /**
+         * @brief Get the newest sample and skip everything before it.
+         * @param sample The sample.
+         * @return False if there is no new sample.
+         */
+        bool readLatest(BMA250Sample *sample);
+
+        /**
+         * @brief Get the number of samples waiting to be read.
+         */
+        uint32_t available(void) const;
+
+        /**
+         * @brief Get the number of samples skipped because the reader was too slow.
+         */
+        uint32_t getDropped(void) const;
+};
+
+#endif
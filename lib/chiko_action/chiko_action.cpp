@@ -2,12 +2,21 @@
 
 
 
+static void runRoutine(void (*Routine)(), void (*ContextRoutine)(void *), void *Context){
+  if (ContextRoutine != NULL){
+    ContextRoutine(Context);
+  }else{
+    Routine();
+  }
+}
+
 static void actionTask(void *param){
   action* thisAction;
   thisAction = (action*) param;
-  thisAction->taskRoutines.EnterRoutine();
+  routines &r = thisAction->taskRoutines;
+  runRoutine(r.EnterRoutine, r.EnterContextRoutine, r.Context);
   while(thisAction->executeAction ){
-    thisAction->taskRoutines.LoopRoutine();
+    runRoutine(r.LoopRoutine, r.LoopContextRoutine, r.Context);
     
     if (thisAction->LoopItrations < U_LONGLONGMAX && thisAction->LoopItrations != 0){
       thisAction->LoopItrations--;
@@ -15,7 +24,7 @@ static void actionTask(void *param){
       thisAction->executeAction = false;
     }
   }
-  thisAction->taskRoutines.ExitRoutine();
+  runRoutine(r.ExitRoutine, r.ExitContextRoutine, r.Context);
   thisAction->actionTaskHandle = NULL;
   vTaskDelete(xTaskGetCurrentTaskHandle());
 }
@@ -25,6 +34,22 @@ static void actionTask(void *param){
     taskRoutines.EnterRoutine = EnterRoutine;
     taskRoutines.LoopRoutine = LoopRoutine;
     taskRoutines.ExitRoutine = ExitRoutine;
+    taskRoutines.EnterContextRoutine = NULL;
+    taskRoutines.LoopContextRoutine = NULL;
+    taskRoutines.ExitContextRoutine = NULL;
+    taskRoutines.Context = NULL;
+    
+ }
+
+ void action::create(void (*EnterRoutine)(void *), void (*LoopRoutine)(void *), void (*ExitRoutine)(void *), void *Context){
+    
+    taskRoutines.EnterRoutine = NULL;
+    taskRoutines.LoopRoutine = NULL;
+    taskRoutines.ExitRoutine = NULL;
+    taskRoutines.EnterContextRoutine = EnterRoutine;
+    taskRoutines.LoopContextRoutine = LoopRoutine;
+    taskRoutines.ExitContextRoutine = ExitRoutine;
+    taskRoutines.Context = Context;
     
  }
 
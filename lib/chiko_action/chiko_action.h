@@ -11,6 +11,11 @@ struct routines{
   void (*EnterRoutine)();
   void (*LoopRoutine)(); 
   void (*ExitRoutine)(); 
+  // Routines taking a context pointer, used instead of the above when set
+  void (*EnterContextRoutine)(void *);
+  void (*LoopContextRoutine)(void *);
+  void (*ExitContextRoutine)(void *);
+  void *Context;
 };
 
 class action{
@@ -21,6 +26,7 @@ class action{
   bool executeAction = false;
   unsigned long long LoopItrations = U_LONGLONGMAX;
   void create(void (*EnterRoutine)(), void (*LoopRoutine)(), void (*ExitRoutine)() );
+  void create(void (*EnterRoutine)(void *), void (*LoopRoutine)(void *), void (*ExitRoutine)(void *), void *Context);
   void begin(unsigned long long MaxLoopCount = U_LONGLONGMAX);
   void stop();
   
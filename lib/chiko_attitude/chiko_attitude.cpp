@@ -0,0 +1,121 @@
+#include "chiko_attitude.h"
+
+#define Q16_ONE           ((int32_t)1 << 16)
+#define Q16_DEGREES(d)    ((int32_t)((d) * 65536.0 + 0.5))
+
+// atan(r) ~ 45 r + r (1 - r) (14.02 + 3.80 r) degrees for 0 <= r <= 1
+#define ATAN_C1           Q16_DEGREES(14.0199)
+#define ATAN_C2           Q16_DEGREES(3.7987)
+
+AttitudeFilter::AttitudeFilter() : Attitude(0) {
+}
+
+int32_t AttitudeFilter::fastAtan2(int32_t y, int32_t x) {
+  if (x == 0 && y == 0) {
+    return 0;
+  }
+  int64_t ax = x < 0 ? -(int64_t)x : x;
+  int64_t ay = y < 0 ? -(int64_t)y : y;
+  bool steep = ay > ax;
+  // Ratio of the smaller to the larger component, Q15 in [0, 1]
+  int64_t r = steep ? (ax << 15) / ay : (ay << 15) / ax;
+  int64_t poly = ATAN_C1 + ((ATAN_C2 * r) >> 15);
+  int64_t angle = 45 * r * 2 + ((poly * ((r * (32768 - r)) >> 15)) >> 15);
+  if (steep) {
+    angle = Q16_DEGREES(90) - angle;
+  }
+  if (x < 0) {
+    angle = Q16_DEGREES(180) - angle;
+  }
+  return (int32_t)(y < 0 ? -angle : angle);
+}
+
+/*
+    First order low-pass, alpha = 1 - exp(-2 pi fc T), computed once
+    */
+void AttitudeFilter::setCutoff(float cutoffHz, uint32_t samplePeriodUs) {
+  float alpha = 1 - expf(-2 * PI * cutoffHz * samplePeriodUs / 1000000);
+  Alpha = constrain((int32_t)(alpha * Q16_ONE), 1, Q16_ONE);
+  GravitySquared = BMA250_LSB_PER_G * BMA250_LSB_PER_G;
+}
+
+void AttitudeFilter::update(const int16_t axis[3]) {
+  if (!Primed) {
+    for (uint8_t i = 0; i < 3; i++) {
+      Gravity[i] = (int32_t)axis[i] << ATTITUDE_STATE_Q;
+    }
+    Primed = true;
+  }
+
+  // Trust the sample less while the robot accelerates
+  int32_t magnitude = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+  int32_t tolerance = (int32_t)(GravitySquared * ATTITUDE_MOVING_TOLERANCE);
+  int32_t alpha = Alpha;
+  if (magnitude > GravitySquared + tolerance || magnitude < GravitySquared - tolerance) {
+    alpha /= ATTITUDE_MOVING_DIVIDER;
+  }
+
+  for (uint8_t i = 0; i < 3; i++) {
+    int32_t error = ((int32_t)axis[i] << ATTITUDE_STATE_Q) - Gravity[i];
+    Gravity[i] += (int32_t)(((int64_t)error * alpha) >> ATTITUDE_STATE_Q);
+  }
+
+  // Same convention as BMA250::getPitchAngle() and getRollAngle()
+  int32_t pitch = fastAtan2(Gravity[BMA250_AXIS_Z], Gravity[BMA250_AXIS_Y]) - Q16_DEGREES(90);
+  int32_t roll = fastAtan2(Gravity[BMA250_AXIS_Z], Gravity[BMA250_AXIS_X]) - Q16_DEGREES(90);
+  if (pitch < -Q16_DEGREES(180)) {
+    pitch += Q16_DEGREES(360);
+  }
+  if (roll < -Q16_DEGREES(180)) {
+    roll += Q16_DEGREES(360);
+  }
+  // Both angles are published together, a reader never mixes two updates
+  uint16_t pitchQ = (uint16_t)(int16_t)(pitch >> (16 - ATTITUDE_ANGLE_Q));
+  uint16_t rollQ = (uint16_t)(int16_t)(roll >> (16 - ATTITUDE_ANGLE_Q));
+  Attitude.store(((uint32_t)pitchQ << 16) | rollQ, std::memory_order_release);
+}
+
+void AttitudeFilter::filterTask(void *param) {
+  AttitudeFilter *filter = (AttitudeFilter *)param;
+  BMA250Sample sample;
+  while (1) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    while (filter->Reader.read(&sample)) {
+      filter->update(sample.axis);
+    }
+  }
+}
+
+void AttitudeFilter::begin(BMA250 *sensor, float cutoffHz) {
+  if (FilterTaskHandle != NULL) {
+    return;
+  }
+  Sensor = sensor;
+  setCutoff(cutoffHz, sensor->getSamplePeriodUs());
+  sensor->startSampling();
+  Reader = sensor->createReader();
+  xTaskCreate(filterTask, "Attitude Filter", ATTITUDE_TASK_STACK_SIZE, this, ATTITUDE_TASK_PRIORITY, &FilterTaskHandle);
+  sensor->addSampleListener(FilterTaskHandle);
+}
+
+int16_t AttitudeFilter::getPitchQ(void) {
+  return (int16_t)(Attitude.load(std::memory_order_acquire) >> 16);
+}
+
+int16_t AttitudeFilter::getRollQ(void) {
+  return (int16_t)(Attitude.load(std::memory_order_acquire) & 0xFFFF);
+}
+
+float AttitudeFilter::getPitch(void) {
+  return getPitchQ() / (float)(1 << ATTITUDE_ANGLE_Q);
+}
+
+float AttitudeFilter::getRoll(void) {
+  return getRollQ() / (float)(1 << ATTITUDE_ANGLE_Q);
+}
+
+void AttitudeFilter::getAttitude(float *pitch, float *roll) {
+  uint32_t attitude = Attitude.load(std::memory_order_acquire);
+  *pitch = (int16_t)(attitude >> 16) / (float)(1 << ATTITUDE_ANGLE_Q);
+  *roll = (int16_t)(attitude & 0xFFFF) / (float)(1 << ATTITUDE_ANGLE_Q);
+}
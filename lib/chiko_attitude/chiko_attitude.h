@@ -0,0 +1,106 @@
+#ifndef __CHIKO_ATTITUDE__
+#define __CHIKO_ATTITUDE__
+
+#include <Arduino.h>
+#include <RTOS.h>
+#include <atomic>
+#include <chiko_BMA250.h>
+
+/*
+    Attitude filter
+    Low-pass filters the gravity vector measured by the BMA250 in fixed point and
+    derives pitch and roll with an integer atan2. Each sample costs a few integer
+    multiplies, reading the attitude is a single atomic load.
+*/
+#define ATTITUDE_TASK_PRIORITY      5
+#define ATTITUDE_TASK_STACK_SIZE    2048
+#define ATTITUDE_DEFAULT_CUTOFF     5     // [Hz] Cutoff of the gravity low-pass filter
+
+#define ATTITUDE_STATE_Q            16    // Fraction bits of the filter state and coefficients
+#define ATTITUDE_ANGLE_Q            7     // Fraction bits of the published angles, 1/128 degree
+
+/*
+    While the measured acceleration is off 1 g by more than this share the robot
+    is accelerating, the filter then slows down by ATTITUDE_MOVING_DIVIDER so
+    steps and bumps do not tilt the estimate.
+*/
+#define ATTITUDE_MOVING_TOLERANCE   (float)0.25
+#define ATTITUDE_MOVING_DIVIDER     4
+
+/**
+ * @class AttitudeFilter
+ * @brief Filtered pitch and roll of the robot from the BMA250 sample stream.
+ */
+class AttitudeFilter{
+    private:
+        int32_t Gravity[3] = {0, 0, 0};  // Filtered raw acceleration, Q16 LSB
+        int32_t Alpha = 0;               // Smoothing factor, Q16
+        int32_t GravitySquared = 0;      // 1 g squared in raw LSB
+        bool Primed = false;             // False until the first sample sets the state
+        std::atomic<uint32_t> Attitude;  // Pitch (high half) and roll (low half), Q7 degrees
+        BMA250 *Sensor = NULL;
+        BMA250Reader Reader;
+        TaskHandle_t FilterTaskHandle = NULL;
+
+        static void filterTask(void *param);
+
+    public:
+        AttitudeFilter();
+
+        /**
+         * @brief Filter the stream of a sampling sensor from a dedicated task.
+         *        Starts the sampling of the sensor if needed.
+         * @param sensor The accelerometer.
+         * @param cutoffHz Cutoff of the low-pass filter in Hz.
+         */
+        void begin(BMA250 *sensor, float cutoffHz = ATTITUDE_DEFAULT_CUTOFF);
+
+        /**
+         * @brief Set the cutoff of the filter for a sampling period.
+         * @param cutoffHz Cutoff in Hz.
+         * @param samplePeriodUs Period of the samples in uS.
+         */
+        void setCutoff(float cutoffHz, uint32_t samplePeriodUs);
+
+        /**
+         * @brief Feed one sample to the filter. Called by the filter task, or by
+         *        hand when the filter is used without begin().
+         * @param axis Raw X, Y and Z of the sample.
+         */
+        void update(const int16_t axis[3]);
+
+        /**
+         * @brief Get the filtered pitch in Q7 degrees.
+         */
+        int16_t getPitchQ(void);
+
+        /**
+         * @brief Get the filtered roll in Q7 degrees.
+         */
+        int16_t getRollQ(void);
+
+        /**
+         * @brief Get the filtered pitch in degrees.
+         */
+        float getPitch(void);
+
+        /**
+         * @brief Get the filtered roll in degrees.
+         */
+        float getRoll(void);
+
+        /**
+         * @brief Get pitch and roll of the same filter update.
+         * @param pitch Pitch in degrees.
+         * @param roll Roll in degrees.
+         */
+        void getAttitude(float *pitch, float *roll);
+
+        /**
+         * @brief Integer atan2, max error about 0.1 degree.
+         * @return Angle of (x, y) in Q16 degrees, -180 to 180.
+         */
+        static int32_t fastAtan2(int32_t y, int32_t x);
+};
+
+#endif
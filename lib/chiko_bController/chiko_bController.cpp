@@ -6,56 +6,54 @@
 
 void (*onControllerConnect)() = NULL, (*onControllerDisconnect)() = NULL, (*ControllerActions)() = NULL;
 
-TaskHandle_t ControllerReadTaskHandle;
 
+/*
+    Called by the BLE client once the pad is connected and set up
+    */
+static void handleConnect(NimBLEAddress address) {
+  wasConnected = true;
 
-static void ControllerReadTask(void* param) {
-  while (1) {
-
-    // Check current connection state
-    bool nowConnected = controller.isConnected();
-
-    // --- onConnect edge ---
-    if (nowConnected && !wasConnected) {
-
-      // Short hello rumble: medium main motors, light triggers, ~200 ms
-      sendVibration(/*left*/ 180, /*right*/ 180, /*LT*/ 50, /*RT*/ 50, /*ms*/ 200, /*cycles*/ 1);
-
-      onControllerConnect();
-    }
-    // --- onDisconnect edge ---
-    else if (!nowConnected && wasConnected) {
-      onControllerDisconnect();
-    }
-
-    // When connected, read the latest controls
-    if (nowConnected) {
-      controller.readControls(lastControls);  // fills struct with current state
-      ControllerActions();
-    }
+  // Short hello rumble: medium main motors, light triggers, ~200 ms
+  sendVibration(/*left*/ 180, /*right*/ 180, /*LT*/ 50, /*RT*/ 50, /*ms*/ 200, /*cycles*/ 1);
 
+  if (onControllerConnect != NULL) {
+    onControllerConnect();
+  }
+}
 
-    // Remember state for the next iteration
-    wasConnected = nowConnected;
+static void handleDisconnect(NimBLEAddress address) {
+  wasConnected = false;
+  if (onControllerDisconnect != NULL) {
+    onControllerDisconnect();
+  }
+}
 
-    // Small sleep; BLE-Gamepad-Client polling doesn’t require tight loops
-    delay(5);
+/*
+    Called for every button edge or axis move, nothing runs while the pad is idle
+    */
+static void handleInputEvent(BLEInputEvent& e) {
+  lastInputEvent = e;
+  controller.readControls(lastControls);
+  if (ControllerActions != NULL) {
+    ControllerActions();
   }
 }
 
 void initialize_bController(void (*onConnect)(), void (*onDisconnect)(), void (*readController)()) {
 
+  onControllerConnect = onConnect;
+  onControllerDisconnect = onDisconnect;
+  ControllerActions = readController;
+
+  controller.onConnect(handleConnect);
+  controller.onDisconnect(handleDisconnect);
+  controller.onInputEvent(handleInputEvent);
+
   // Start BLE and begin scanning for gamepads (Xbox supported)
   controller.begin();
 
   Serial.println("BLE-Gamepad-Client started. "
                  "Put the Xbox controller into pairing mode to connect.");
-
-  onControllerConnect = onConnect;
-  onControllerDisconnect = onDisconnect;
-  ControllerActions = readController;
-
-  xTaskCreate(ControllerReadTask, "Controller update", 5000, NULL, 3, &ControllerReadTaskHandle);
 }
 
 
@@ -68,12 +66,12 @@ void printControllerInfo() {
     lastPrint = now;
     Serial.printf("LX:%+.2f LY:%+.2f  RX:%+.2f RY:%+.2f  "
                   "LT:%.2f RT:%.2f  A:%d B:%d X:%d Y:%d  LB:%d RB:%d\n",
-                  lastControls.leftStickX, lastControls.leftStickY,
-                  lastControls.rightStickX, lastControls.rightStickY,
-                  lastControls.leftTrigger, lastControls.rightTrigger,
-                  lastControls.buttonA, lastControls.buttonB,
-                  lastControls.buttonX, lastControls.buttonY,
-                  lastControls.leftBumper, lastControls.rightBumper);
+                  lastControls.leftStickX(), lastControls.leftStickY(),
+                  lastControls.rightStickX(), lastControls.rightStickY(),
+                  lastControls.leftTrigger(), lastControls.rightTrigger(),
+                  lastControls.buttonA(), lastControls.buttonB(),
+                  lastControls.buttonX(), lastControls.buttonY(),
+                  lastControls.leftBumper(), lastControls.rightBumper());
   }
 }
 
@@ -11,9 +11,13 @@
 BLEController controller;       // main BLE-Gamepad-Client object
 bool wasConnected = false;      // previous connection state
 
-// Optional: keep last controls to use outside the read loop
+// Latest controls, updated before every call of the readController callback
 BLEControlsEvent lastControls;
 
+// The change that triggered the current readController call: a button pressed or
+// released, or an axis moved (see BLEInputEvent)
+BLEInputEvent lastInputEvent;
+
 
 // Optional: simple dead-zone for sticks
 static const float DEADZONE = 0.10f;
@@ -35,6 +39,8 @@ void printControllerInfo(void);
 float dz(float v);
 
 // --- MainFunction ---------------------------------------------------------------
+// The callbacks run on the dispatch task of BLE-Gamepad-Client, readController once
+// per input event, so only when a button or an axis actually changed.
 void initialize_bController(void (*onConnect)()=NULL,void (*onDisconnect)()=NULL, void (*readController)() = NULL );
 
 
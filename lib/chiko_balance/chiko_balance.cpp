@@ -0,0 +1,94 @@
+#include "chiko_balance.h"
+
+/*
+    Fixed rate loop. While disabled the task ramps the correction down and then
+    sleeps until enable() wakes it again.
+    */
+void BalanceController::balanceTask(void *param) {
+  BalanceController *controller = (BalanceController *)param;
+  TickType_t lastWake = xTaskGetTickCount();
+  while (1) {
+    if (!controller->Enabled.load() && controller->Output.load() == 0) {
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+      lastWake = xTaskGetTickCount();
+    }
+    vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(BALANCE_UPDATE_RATE));
+    controller->step(BALANCE_UPDATE_RATE / (float)1000);
+  }
+}
+
+void BalanceController::step(float dt) {
+  float target = 0;
+  if (Enabled.load()) {
+    float roll = Attitude->getRoll();
+    float error = SetPoint - roll;
+    // Derivative on the measurement, a new setpoint does not kick the feet
+    float derivative = Primed ? (LastRoll - roll) / dt : 0;
+    LastRoll = roll;
+    Primed = true;
+
+    float unclamped = Kp * error + Integral + Kd * derivative;
+    target = constrain(unclamped, -OutputLimit, OutputLimit);
+    // Anti-windup: stop integrating while the output is saturated in the direction of the error
+    if (unclamped == target || (unclamped > target) != (error > 0)) {
+      Integral = constrain(Integral + Ki * error * dt, -OutputLimit, OutputLimit);
+    }
+  } else {
+    Integral = 0;
+    Primed = false;
+  }
+
+  float maxStep = SlewRate * dt;
+  float output = Output.load();
+  output += constrain(target - output, -maxStep, maxStep);
+  Output.store(output);
+  LeftFoot->setTrim(BALANCE_LEFT_FOOT_SIGN * output);
+  RightFoot->setTrim(BALANCE_RIGHT_FOOT_SIGN * output);
+}
+
+void BalanceController::begin(AttitudeFilter *attitude, Joint *leftFoot, Joint *rightFoot) {
+  if (BalanceTaskHandle != NULL) {
+    return;
+  }
+  Attitude = attitude;
+  LeftFoot = leftFoot;
+  RightFoot = rightFoot;
+  xTaskCreate(balanceTask, "Balance", BALANCE_TASK_STACK_SIZE, this, BALANCE_TASK_PRIORITY, &BalanceTaskHandle);
+}
+
+void BalanceController::enable(void) {
+  Enabled.store(true);
+  if (BalanceTaskHandle != NULL) {
+    xTaskNotifyGive(BalanceTaskHandle);
+  }
+}
+
+void BalanceController::disable(void) {
+  Enabled.store(false);
+}
+
+bool BalanceController::isEnabled(void) {
+  return Enabled.load();
+}
+
+void BalanceController::setGains(float kp, float ki, float kd) {
+  Kp = kp;
+  Ki = ki;
+  Kd = kd;
+}
+
+void BalanceController::setSetPoint(float roll) {
+  SetPoint = roll;
+}
+
+void BalanceController::setOutputLimit(float limit) {
+  OutputLimit = limit;
+}
+
+void BalanceController::setSlewRate(float slewRate) {
+  SlewRate = slewRate;
+}
+
+float BalanceController::getOutput(void) {
+  return Output.load();
+}
@@ -0,0 +1,123 @@
+#ifndef __CHIKO_BALANCE__
+#define __CHIKO_BALANCE__
+
+#include <Arduino.h>
+#include <RTOS.h>
+#include <atomic>
+#include <chiko_attitude.h>
+#include <chiko_joint.h>
+
+/*
+    Balance controller
+    Keeps the robot level by tilting both feet against the filtered roll. The
+    correction is written as a joint trim, so it is added on top of whatever
+    pose or gait the action tasks are playing. It runs above the action tasks
+    and below the sensor tasks.
+*/
+#define BALANCE_TASK_PRIORITY     4
+#define BALANCE_TASK_STACK_SIZE   2048
+#define BALANCE_UPDATE_RATE       10    // [mS] 10 mS is 100 Hz
+
+// Default gains, tuned on test_standLevelled
+#define BALANCE_DEFAULT_KP            (float)1.0
+#define BALANCE_DEFAULT_KI            (float)0.05  // [1/s]
+#define BALANCE_DEFAULT_KD            (float)0.0   // [s]
+#define BALANCE_DEFAULT_OUTPUT_LIMIT  (float)50    // [deg] Largest correction of the feet
+#define BALANCE_DEFAULT_SLEW_RATE     (float)DEFAULT_JOINT_SPEED // [deg/s] Fastest change of the correction
+
+// Direction of the correction for each foot, -1 if a foot is mounted mirrored
+#define BALANCE_LEFT_FOOT_SIGN    1
+#define BALANCE_RIGHT_FOOT_SIGN   1
+
+/**
+ * @class BalanceController
+ * @brief Fixed rate PID loop from the filtered roll to the trim of the feet.
+ */
+class BalanceController{
+    private:
+        AttitudeFilter *Attitude = NULL;
+        Joint *LeftFoot = NULL;
+        Joint *RightFoot = NULL;
+        TaskHandle_t BalanceTaskHandle = NULL;
+        std::atomic<bool> Enabled{false};
+
+        float Kp = BALANCE_DEFAULT_KP;
+        float Ki = BALANCE_DEFAULT_KI;
+        float Kd = BALANCE_DEFAULT_KD;
+        float SetPoint = 0;                             // Target roll [deg]
+        float OutputLimit = BALANCE_DEFAULT_OUTPUT_LIMIT;
+        float SlewRate = BALANCE_DEFAULT_SLEW_RATE;
+
+        float Integral = 0;        // Integral term, already scaled by Ki [deg]
+        float LastRoll = 0;        // Roll of the previous step, for the derivative
+        bool Primed = false;       // False until the first step after enabling
+        std::atomic<float> Output{0}; // Correction written to the feet, read by getOutput() from other tasks [deg]
+
+        static void balanceTask(void *param);
+
+    public:
+        /**
+         * @brief Attach the controller to the attitude filter and the feet and start its task.
+         *        The controller starts disabled.
+         * @param attitude Filtered attitude of the robot.
+         * @param leftFoot The left foot joint.
+         * @param rightFoot The right foot joint.
+         */
+        void begin(AttitudeFilter *attitude, Joint *leftFoot, Joint *rightFoot);
+
+        /**
+         * @brief Start correcting the feet, also while an action is playing.
+         */
+        void enable(void);
+
+        /**
+         * @brief Stop correcting, the correction ramps back to zero at the slew rate.
+         */
+        void disable(void);
+
+        /**
+         * @brief Check if the controller is correcting the feet.
+         */
+        bool isEnabled(void);
+
+        /**
+         * @brief Set the PID gains.
+         * @param kp Proportional gain.
+         * @param ki Integral gain in 1/s.
+         * @param kd Derivative gain in s.
+         */
+        void setGains(float kp, float ki, float kd = 0);
+
+        /**
+         * @brief Set the roll the controller holds.
+         * @param roll Target roll in degrees (default level: 0).
+         */
+        void setSetPoint(float roll);
+
+        /**
+         * @brief Set the largest correction of the feet.
+         * @param limit Limit in degrees.
+         */
+        void setOutputLimit(float limit);
+
+        /**
+         * @brief Set the fastest change of the correction.
+         * @param slewRate Rate in degrees/second.
+         */
+        void setSlewRate(float slewRate);
+
+        /**
+         * @brief Get the correction currently applied to the feet.
+         * @return Correction in degrees.
+         */
+        float getOutput(void);
+
+        /**
+         * @brief Run the controller once. Normally called by the balance task every
+         *        BALANCE_UPDATE_RATE mS.
+         * @param dt Time since the last step in seconds.
+         */
+        void step(float dt);
+};
+
+#endif
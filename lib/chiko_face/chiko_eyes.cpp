@@ -0,0 +1,130 @@
+#include "chiko_eyes.h"
+#include <string.h>
+
+static float ease(uint8_t easing, float t) {
+  switch (easing) {
+    case EASE_IN:
+      return t * t;
+    case EASE_OUT:
+      return t * (2 - t);
+    case EASE_IN_OUT:
+      return t * t * (3 - 2 * t);
+    case EASE_LINEAR:
+    default:
+      return t;
+  }
+}
+
+static int16_t lerp(int16_t from, int16_t to, float t) {
+  return from + (int16_t)lroundf((to - from) * t);
+}
+
+static EyeShape lerpShape(const EyeShape &from, const EyeShape &to, float t) {
+  EyeShape shape;
+  shape.x = lerp(from.x, to.x, t);
+  shape.y = lerp(from.y, to.y, t);
+  shape.width = lerp(from.width, to.width, t);
+  shape.height = lerp(from.height, to.height, t);
+  return shape;
+}
+
+static EyeShape addShape(const EyeShape &base, const EyeShape &offset) {
+  EyeShape shape;
+  shape.x = base.x + offset.x;
+  shape.y = base.y + offset.y;
+  shape.width = base.width + offset.width;
+  shape.height = base.height + offset.height;
+  return shape;
+}
+
+EyeState EyeAnimator::getTarget(const EyeKeyframe &keyframe) {
+  if (keyframe.mode == EYE_ABSOLUTE) {
+    return keyframe.state;
+  }
+  EyeState target;
+  target.left = addShape(Base.left, keyframe.state.left);
+  target.right = addShape(Base.right, keyframe.state.right);
+  target.radius = Base.radius + keyframe.state.radius;
+  target.lid = Base.lid + keyframe.state.lid;
+  return target;
+}
+
+void EyeAnimator::startExpression(uint32_t startMs) {
+  Base = Current;
+  From = Current;
+  Keyframe = 0;
+  KeyframeStartMs = startMs;
+  Running = true;
+}
+
+void EyeAnimator::reset(const EyeState &state) {
+  Current = state;
+  QueueCount = 0;
+  Running = false;
+}
+
+bool EyeAnimator::play(const EyeExpression &expression, bool interrupt) {
+  if (interrupt) {
+    QueueCount = 0;
+    Running = false;
+  }
+  if (QueueCount >= EYES_QUEUE_LENGTH || expression.count == 0) {
+    return false;
+  }
+  Queue[(QueueHead + QueueCount) % EYES_QUEUE_LENGTH] = expression;
+  QueueCount++;
+  return true;
+}
+
+bool EyeAnimator::update(uint32_t nowMs) {
+  if (QueueCount == 0) {
+    return false;
+  }
+  EyeState previous = Current;
+  if (!Running) {
+    // Blend in from wherever the eyes are
+    startExpression(nowMs);
+  }
+
+  while (QueueCount > 0) {
+    const EyeExpression &expression = Queue[QueueHead];
+    const EyeKeyframe &keyframe = expression.keyframes[Keyframe];
+    EyeState target = getTarget(keyframe);
+    uint32_t elapsed = nowMs - KeyframeStartMs;
+    if (elapsed < keyframe.durationMs) {
+      float t = ease(keyframe.easing, elapsed / (float)keyframe.durationMs);
+      Current.left = lerpShape(From.left, target.left, t);
+      Current.right = lerpShape(From.right, target.right, t);
+      Current.radius = lerp(From.radius, target.radius, t);
+      Current.lid = lerp(From.lid, target.lid, t);
+      break;
+    }
+
+    // Keyframe done, the next one starts exactly where this one ended
+    Current = target;
+    From = target;
+    KeyframeStartMs += keyframe.durationMs;
+    Keyframe++;
+    if (Keyframe >= expression.count) {
+      QueueHead = (QueueHead + 1) % EYES_QUEUE_LENGTH;
+      QueueCount--;
+      Running = false;
+      if (QueueCount > 0) {
+        startExpression(KeyframeStartMs);
+      }
+    }
+  }
+  return memcmp(&previous, &Current, sizeof(EyeState)) != 0;
+}
+
+const EyeState &EyeAnimator::getState(void) {
+  return Current;
+}
+
+bool EyeAnimator::isAnimating(void) {
+  return QueueCount > 0;
+}
+
+uint8_t EyeAnimator::getQueued(void) {
+  return QueueCount;
+}
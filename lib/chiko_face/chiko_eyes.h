@@ -0,0 +1,138 @@
+#ifndef __CHIKO_EYES__
+#define __CHIKO_EYES__
+
+#include <Arduino.h>
+
+/*
+    Eye animation engine
+    An expression is a short list of keyframes, each one tweens the eyes from
+    where they are to a target state over a duration with an easing curve. The
+    animator only evaluates the tween at the current time, so a render tick costs
+    the same for a blink and for a one second stare, and nothing ever waits.
+*/
+#define EYES_MAX_KEYFRAMES   6    // Keyframes of one expression
+#define EYES_QUEUE_LENGTH    4    // Expressions waiting to be played, the playing one included
+#define EYES_FRAME_MS        16   // [mS] Render tick of the eyes, about 60 frames per second
+
+/**
+ * @enum EYE_EASING
+ * @brief Easing curve of a keyframe.
+ */
+enum EYE_EASING {
+    EASE_LINEAR,
+    EASE_IN,       // Starts slow
+    EASE_OUT,      // Ends slow
+    EASE_IN_OUT    // Starts and ends slow
+};
+
+/**
+ * @enum EYE_KEYFRAME_MODE
+ * @brief How the target state of a keyframe is given.
+ */
+enum EYE_KEYFRAME_MODE {
+    EYE_ABSOLUTE,  // The target is the state itself
+    EYE_RELATIVE   // The target is added to the state the expression started from
+};
+
+/**
+ * @struct EyeShape
+ * @brief Centre and size of one eye in pixels.
+ */
+struct EyeShape {
+    int16_t x;
+    int16_t y;
+    int16_t width;
+    int16_t height;
+};
+
+/**
+ * @struct EyeState
+ * @brief Everything the renderer needs to draw both eyes.
+ */
+struct EyeState {
+    EyeShape left;
+    EyeShape right;
+    int16_t radius;  // Corner radius of both eyes
+    int16_t lid;     // How far the lower lids cover the eyes (happy eyes), 0 for none
+};
+
+/**
+ * @struct EyeKeyframe
+ * @brief One tween of an expression.
+ */
+struct EyeKeyframe {
+    EyeState state;       // Target (or offset, see mode) of the tween
+    uint16_t durationMs;  // Duration of the tween, 0 jumps to the target
+    uint8_t easing;       // EYE_EASING
+    uint8_t mode;         // EYE_KEYFRAME_MODE
+};
+
+/**
+ * @struct EyeExpression
+ * @brief Keyframes played one after the other, e.g. a blink or a saccade.
+ */
+struct EyeExpression {
+    EyeKeyframe keyframes[EYES_MAX_KEYFRAMES];
+    uint8_t count;
+};
+
+/**
+ * @class EyeAnimator
+ * @brief Plays queued eye expressions against time.
+ *        Not thread safe, the task that renders the eyes owns the animator.
+ */
+class EyeAnimator{
+    private:
+        EyeState Current = {};                      // State at the last update
+        EyeState From = {};                         // State the running keyframe started from
+        EyeState Base = {};                         // State the running expression started from
+        EyeExpression Queue[EYES_QUEUE_LENGTH];
+        uint8_t QueueHead = 0;
+        uint8_t QueueCount = 0;
+        uint8_t Keyframe = 0;                       // Running keyframe of the expression at the head
+        uint32_t KeyframeStartMs = 0;
+        bool Running = false;                       // The expression at the head has started
+
+        EyeState getTarget(const EyeKeyframe &keyframe);
+        void startExpression(uint32_t startMs);
+
+    public:
+        /**
+         * @brief Stop every expression and jump to a state.
+         * @param state The new state of the eyes.
+         */
+        void reset(const EyeState &state);
+
+        /**
+         * @brief Play an expression after the queued ones, or right away.
+         * @param expression The expression, copied into the queue.
+         * @param interrupt If true, the queue is dropped and the expression blends in from
+         *        wherever the eyes are now.
+         * @return False if the queue is full.
+         */
+        bool play(const EyeExpression &expression, bool interrupt = false);
+
+        /**
+         * @brief Advance the animation to a time.
+         * @param nowMs Current time in mS, e.g. millis().
+         * @return True if the state changed and the eyes must be drawn again.
+         */
+        bool update(uint32_t nowMs);
+
+        /**
+         * @brief Get the state of the last update.
+         */
+        const EyeState &getState(void);
+
+        /**
+         * @brief Check if an expression is playing or queued.
+         */
+        bool isAnimating(void);
+
+        /**
+         * @brief Get the number of expressions playing or queued.
+         */
+        uint8_t getQueued(void);
+};
+
+#endif
@@ -10,9 +10,17 @@
 
 #include "chiko_face.h"
 #include <string>
-#include <deque>
-#define MAX_LOG_LINES 6 // Number of lines to show (depends on font size and screen height)
-static std::deque<std::string> message_log;
+#include <string.h>
+#include <atomic>
+#include "chiko_facelog.h"
+#include "chiko_glyphcache.h"
+#include "chiko_sprite.h"
+#include <chiko_fill.h>
+
+static FaceLog face_log;
+static const uint8_t *face_log_font = NULL;   // Font the log is wrapped with
+static bool face_log_shown = false;           // The display still shows the log as it was last drawn
+static uint32_t face_log_first_row = 0;       // Log row at the top of the display
 
 
 // Color definitions for display
@@ -52,163 +60,299 @@ int corner_radius = ref_corner_radius;
 U8G2_SSD1309_128X64_NONAME2_F_4W_HW_SPI u8g2(U8G2_R0, /* cs=*/U8X8_PIN_NONE, /* dc=*/26, /* reset=*/25);
 static bool u8g2_initialized = false;
 
+// Double buffered frame. The front buffer holds the frame on the display (or on its
+// way there), the back buffer is the one u8g2 draws into. A swap compares the two
+// tile by tile and only sends the 8x8 tiles that changed.
+static const int DISPLAY_TILE_ROWS = SCREEN_HEIGHT / 8;
+static const int DISPLAY_TILE_COLUMNS = SCREEN_WIDTH / 8;
+static const int DISPLAY_FRAME_SIZE = SCREEN_WIDTH * DISPLAY_TILE_ROWS;
+static uint8_t display_second_frame[DISPLAY_FRAME_SIZE]; // The first frame is the buffer of u8g2
+static uint8_t *display_frames[2] = {NULL, display_second_frame};
+static uint32_t display_frame_fence[2] = {0, 0}; // Transfer fence of the last flush of each frame
+static int display_back = 0;
+static bool display_front_valid = false;
+
+// ---- Face render task -------------------------------------------------------
+// Only FaceEmojiTask draws. The public face functions copy a command into the
+// queue and return, they never touch u8g2 or wait for the display.
+
+/**
+ * @enum FACE_COMMAND
+ * @brief What a queued face command draws.
+ */
+enum FACE_COMMAND {
+  FACE_EXPRESSION,    // Play an eye expression
+  FACE_PRINT,         // Print text to the log
+  FACE_PRINT_MIDDLE   // Print text centered on the display
+};
+
+/**
+ * @struct FaceCommand
+ * @brief One entry of the face queue, copied in and out by value.
+ */
+struct FaceCommand {
+  uint8_t type;          // FACE_COMMAND
+  uint8_t font_size;     // Text only
+  bool clear;            // Text only, clear the display before printing
+  bool interrupt;        // Expression only, drop the queued expressions
+  union {
+    EyeExpression expression;
+    char text[FACE_TEXT_LENGTH];  // Null terminated
+  };
+};
+
+static QueueHandle_t face_queue = NULL;
+static SemaphoreHandle_t face_queue_lock = NULL;  // Producers hold it from the space check to the last send
+static std::atomic<uint8_t> face_pending_expressions{0};  // Expressions in the face queue
+static std::atomic<bool> face_animating{false};           // The render task is playing an expression
+
+/**
+ * @brief Queues text for the render task, split over as many commands as needed.
+ *        Nothing is queued if the whole text does not fit, so a line is never cut.
+ *        An empty text is still queued once, it clears the display if asked to.
+ * @return False if the text was dropped.
+ */
+static bool face_sendText(FACE_COMMAND type, const char *text, size_t length, uint8_t font_size, bool clear) {
+  if (face_queue == NULL) return false;
+  size_t chunk = FACE_TEXT_LENGTH - 1;
+  size_t count = max((length + chunk - 1) / chunk, (size_t)1);
+  if (type == FACE_PRINT_MIDDLE) {
+    // A centered text is a single line
+    count = 1;
+    length = min(length, chunk);
+  }
+
+  FaceCommand command;
+  command.type = type;
+  command.font_size = font_size;
+  command.clear = clear;
+  command.interrupt = false;
+  // No other producer may take the free entries between the check and the sends
+  xSemaphoreTake(face_queue_lock, portMAX_DELAY);
+  bool sent = uxQueueSpacesAvailable(face_queue) >= count;
+  size_t start = 0;
+  while (sent && count-- > 0) {
+    size_t n = min(chunk, length - start);
+    memcpy(command.text, text + start, n);
+    command.text[n] = '\0';
+    start += n;
+    sent = xQueueSend(face_queue, &command, 0) == pdTRUE;
+  }
+  xSemaphoreGive(face_queue_lock);
+  return sent;
+}
+
+/**
+ * @brief Fence behind the tiles sent so far. On the ESP32 the tiles are sent by DMA straight
+ *        from the front buffer while the caller goes on.
+ */
+static uint32_t display_fence() {
+#ifdef U8X8_HAVE_ESP32_DMA_SPI
+  return u8x8_byte_esp32_dma_spi_fence();
+#else
+  return 0;
+#endif
+}
+
+/**
+ * @brief Waits until the tiles sent before the fence are on the wire.
+ */
+static void display_waitFence(uint32_t fence) {
+#ifdef U8X8_HAVE_ESP32_DMA_SPI
+  u8x8_byte_esp32_dma_spi_wait_fence(fence);
+#endif
+}
+
 // --- Message log for scrolling messages ---
 
+#if FACE_GLYPH_CACHE
+// The fonts of the log and the centered text, drawn from a cache
+static const uint8_t *const face_cached_fonts[] = {u8g2_font_ncenB08_tr, u8g2_font_ncenB10_tr};
+static GlyphCache face_glyph_caches[sizeof(face_cached_fonts) / sizeof(face_cached_fonts[0])];
+#endif
+
+/**
+ * @brief Gets the glyph cache of the current font.
+ * @return The cache, or NULL if the font is not cached.
+ */
+static GlyphCache *face_glyphCache() {
+#if FACE_GLYPH_CACHE
+  for (GlyphCache &cache : face_glyph_caches) {
+    if (cache.isFor(u8g2.getU8g2()->font)) {
+      return &cache;
+    }
+  }
+#endif
+  return NULL;
+}
+
+/**
+ * @brief Draws text with the current font, from the glyph cache if the font has one.
+ */
+static void face_drawText(int x, int y, const char *text) {
+  GlyphCache *cache = face_glyphCache();
+  if (cache != NULL) {
+    cache->drawUTF8(u8g2.getU8g2(), x, y, text);
+  } else {
+    u8g2.drawUTF8(x, y, text);
+  }
+}
+
 /**
- * @brief Prints a message on the display, scrolling old messages up as new ones arrive.
- * @param message The message to print.
+ * @brief Measures text with the current font, from the glyph cache if the font has one.
+ */
+static int face_textWidth(const char *text) {
+  GlyphCache *cache = face_glyphCache();
+  if (cache != NULL) {
+    return cache->getUTF8Width(u8g2.getU8g2(), text);
+  }
+  return u8g2.getUTF8Width(text);
+}
+
+/**
+ * @brief Selects the font of a font size (8, 10, 12, 14, 18, 24).
+ * @return The font.
+ */
+static const uint8_t *face_font(uint8_t font_size, const uint8_t *default_font) {
+  switch (font_size) {
+    case 8: return u8g2_font_ncenB08_tr;
+    case 10: return u8g2_font_ncenB10_tr;
+    case 12: return u8g2_font_ncenB12_tr;
+    case 14: return u8g2_font_ncenB14_tr;
+    case 18: return u8g2_font_ncenB18_tr;
+    case 24: return u8g2_font_ncenB24_tr;
+    default: return default_font;
+  }
+}
+
+/**
+ * @brief Prints a message on the display, scrolling old messages up as new ones arrive. Render task only.
+ *        Only the rows the message changed are drawn again, unless the log scrolled or something else
+ *        was drawn since the last print.
+ * @param message The message to print. '\n' starts a new line.
  * @param font_size The font size to use (8, 10, 12, etc.).
  * @param clear If true, clears the display before printing (default: true).
  */
-// Prints a message to the display, handling newlines and scrolling.
-// - message: The string to print. '\n' triggers a new line and scrolls up if needed.
-// - font_size: Font size to use (8, 10, 12, 14, 18, 24).
-// - clear: If true, clears the display before printing.
-void facePrint(const std::string &message, uint8_t font_size, bool clear) {
+static void face_drawPrint(const char *message, uint8_t font_size, bool clear) {
   if (!u8g2_initialized) return;
-  static std::string line_buffer = ""; // Buffer for the current line being built
-  size_t start = 0;
-  // Process the message, splitting on '\n' and scrolling as needed
-  while (start < message.length()) {
-    size_t newline_pos = message.find('\n', start);
-    if (newline_pos == std::string::npos) {
-      // No more newlines, append rest to buffer
-      line_buffer += message.substr(start);
-      // Update or add the current line in the log
-      if (!message_log.empty()) {
-        message_log.back() = line_buffer;
-      } else {
-        message_log.push_back(line_buffer);
-      }
-      break;
-    } else {
-      // Append up to newline, then push as a new line in the log
-      line_buffer += message.substr(start, newline_pos - start);
-      message_log.push_back(line_buffer);
-      line_buffer.clear();
-      // Scroll up: keep only the last MAX_LOG_LINES lines
-      while (message_log.size() > MAX_LOG_LINES) {
-        message_log.pop_front();
-      }
-      start = newline_pos + 1;
+  const uint8_t *font = face_font(font_size, u8g2_font_ncenB10_tr);
+  u8g2.setFont(font);
+  if (font != face_log_font) {
+    // Measure every glyph once, the log wraps with the table
+    GlyphCache *cache = face_glyphCache();
+    uint8_t advance[FACE_LOG_GLYPHS];
+    for (int i = 0; i < FACE_LOG_GLYPHS; i++) {
+      int8_t glyph_advance = cache != NULL ? cache->getAdvance(FACE_LOG_FIRST_GLYPH + i)
+                                           : u8g2_GetGlyphWidth(u8g2.getU8g2(), FACE_LOG_FIRST_GLYPH + i);
+      advance[i] = max(glyph_advance, (int8_t)0);
     }
+    face_log.setFont(advance, SCREEN_WIDTH);
+    face_log_font = font;
+    face_log_shown = false;
   }
-  // Select font based on font_size
-  switch (font_size) {
-    case 8: u8g2.setFont(u8g2_font_ncenB08_tr); break;
-    case 10: u8g2.setFont(u8g2_font_ncenB10_tr); break;
-    case 12: u8g2.setFont(u8g2_font_ncenB12_tr); break;
-    case 14: u8g2.setFont(u8g2_font_ncenB14_tr); break;
-    case 18: u8g2.setFont(u8g2_font_ncenB18_tr); break;
-    case 24: u8g2.setFont(u8g2_font_ncenB24_tr); break;
-    default: u8g2.setFont(u8g2_font_ncenB10_tr); break;
-  }
-  if (clear) u8g2.clearBuffer();
-  u8g2.setDrawColor(COLOR_WHITE);
+  face_log.append(message, strlen(message));
+
   // Calculate line height for vertical spacing
   int line_height = u8g2.getMaxCharHeight() + 2;
-  int y = line_height; // Start at first line
-  // Draw each message in the log, wrapping long lines
-  for (const auto& msg : message_log) {
-    int x = 0;
-    size_t start = 0;
-    size_t len = msg.length();
-    while (start < len) {
-      // Find how many characters fit in 128 pixels
-      size_t end = start;
-      int w = 0;
-      while (end < len) {
-        std::string sub = msg.substr(start, end - start + 1);
-        w = u8g2.getUTF8Width(sub.c_str());
-        if (w > SCREEN_WIDTH) break;
-        end++;
-      }
-      if (end == start) end++; // Always print at least one character
-      std::string line = msg.substr(start, end - start);
-      u8g2.drawUTF8(x, y, line.c_str()); // Draw the line
-      y += line_height;
-      if (y > SCREEN_HEIGHT) break;
-      start = end;
+  uint32_t visible_rows = min(SCREEN_HEIGHT / line_height, FACE_LOG_ROWS);
+  uint32_t rows = face_log.getRows();
+  uint32_t first_row = rows > visible_rows ? rows - visible_rows : 0;
+  uint32_t changed_row = face_log.takeChanges();
+  if (!clear || !face_log_shown || first_row != face_log_first_row) {
+    // Scrolled, or the display shows something else: draw the whole log
+    if (clear) u8g2.clearBuffer();
+    changed_row = first_row;
+  }
+
+  char text[SCREEN_WIDTH + 1];
+  int ascent = u8g2.getAscent();
+  int descent = u8g2.getDescent();
+  for (uint32_t row = changed_row; row < rows; row++) {
+    int y = (row - first_row + 1) * line_height;
+    if (clear) {
+      // Erase the old text of the row
+      u8g2.setDrawColor(COLOR_BLACK);
+      fill_box(u8g2.getU8g2(), 0, y - ascent, SCREEN_WIDTH, ascent - descent + 1);
     }
-    if (y > SCREEN_HEIGHT) break;
+    face_log.getRow(row, text, sizeof(text));
+    u8g2.setDrawColor(COLOR_WHITE);
+    face_drawText(0, y, text);
   }
-  u8g2.sendBuffer(); // Update the display
+  face_log_first_row = first_row;
+  face_log_shown = clear;
+  display_display(); // Update the display
+}
+
+/**
+ * @brief Prints a single line centered on the display. Render task only, see facePrintMiddle.
+ */
+static void face_drawPrintMiddle(const char *text, bool clear, uint8_t font_size) {
+  if (!u8g2_initialized) return;
+  u8g2.setFont(face_font(font_size, u8g2_font_ncenB08_tr));
+  if (clear) {
+    u8g2.clearBuffer();
+  }
+  face_log_shown = false;
+  u8g2.setDrawColor(COLOR_WHITE);
+  int16_t x, y;
+  uint16_t w, h;
+  w = face_textWidth(text);
+  h = u8g2.getMaxCharHeight();
+  x = (SCREEN_WIDTH - w) / 2; // Center horizontally
+  y = (SCREEN_HEIGHT - h) / 2 + h; // Center vertically (baseline)
+  face_drawText(x, y, text);
+  display_display(); // Update display
 }
 
+void facePrint(const std::string &message, uint8_t font_size, bool clear) {
+  face_sendText(FACE_PRINT, message.c_str(), message.length(), font_size, clear);
+}
 void facePrint(const int number, uint8_t font_size, bool clear) {
-  facePrint(std::to_string(number), font_size, clear);
+  char text[16];
+  face_sendText(FACE_PRINT, text, snprintf(text, sizeof(text), "%d", number), font_size, clear);
 }
 void facePrint(const float number, uint8_t font_size, bool clear) {
-  facePrint(std::to_string(number), font_size, clear);
+  char text[FACE_TEXT_LENGTH];
+  face_sendText(FACE_PRINT, text, min(snprintf(text, sizeof(text), "%f", number), FACE_TEXT_LENGTH - 1), font_size, clear);
 }
 void facePrint(const char message, uint8_t font_size, bool clear) {
-  facePrint(std::string(1, message), font_size, clear);
+  face_sendText(FACE_PRINT, &message, 1, font_size, clear);
 }
 
 void facePrintln(const std::string &message, uint8_t font_size, bool clear) {
-  facePrint(message + '\n', font_size, clear);
+  // One text, so the newline is queued with the line and cannot clear it again
+  std::string line = message + '\n';
+  face_sendText(FACE_PRINT, line.c_str(), line.length(), font_size, clear);
 }
 void facePrintln(const int number, uint8_t font_size, bool clear) {
-  facePrint(std::to_string(number) + '\n', font_size, clear);
+  char text[16];
+  face_sendText(FACE_PRINT, text, snprintf(text, sizeof(text), "%d\n", number), font_size, clear);
 }
 void facePrintln(const float number, uint8_t font_size, bool clear) {
-  facePrint(std::to_string(number) + '\n', font_size, clear);
+  char text[FACE_TEXT_LENGTH];
+  face_sendText(FACE_PRINT, text, min(snprintf(text, sizeof(text), "%f\n", number), FACE_TEXT_LENGTH - 1), font_size, clear);
 }
 void facePrintln(const char message, uint8_t font_size, bool clear) {
-  facePrint(std::string(1, message) + '\n', font_size, clear);
+  char text[2] = {message, '\n'};
+  face_sendText(FACE_PRINT, text, 2, font_size, clear);
 }
 
-
 void facePrintMiddle(const std::string &text, bool clear, uint8_t font_size) {
-  if (!u8g2_initialized) return;
-  // Select font based on font_size parameter
-  switch (font_size) {
-    case 8:
-      u8g2.setFont(u8g2_font_ncenB08_tr); // 8pt font
-      break;
-    case 10:
-      u8g2.setFont(u8g2_font_ncenB10_tr); // 10pt font
-      break;
-    case 12:
-      u8g2.setFont(u8g2_font_ncenB12_tr); // 12pt font
-      break;
-    case 14:
-      u8g2.setFont(u8g2_font_ncenB14_tr); // 14pt font
-      break;
-    case 18:
-      u8g2.setFont(u8g2_font_ncenB18_tr); // 18pt font
-      break;
-    case 24:
-      u8g2.setFont(u8g2_font_ncenB24_tr); // 24pt font
-      break;
-    default:
-      u8g2.setFont(u8g2_font_ncenB08_tr); // Default to 8pt font
-      break;
-  }
-  if (clear) {
-    u8g2.clearBuffer();
-  }
-  u8g2.setDrawColor(COLOR_WHITE);
-  int16_t x, y;
-  uint16_t w, h;
-  w = u8g2.getUTF8Width(text.c_str());
-  h = u8g2.getMaxCharHeight();
-  x = (SCREEN_WIDTH - w) / 2; // Center horizontally
-  y = (SCREEN_HEIGHT - h) / 2 + h; // Center vertically (baseline)
-  u8g2.drawUTF8(x, y, text.c_str());
-  u8g2.sendBuffer(); // Update display
+  face_sendText(FACE_PRINT_MIDDLE, text.c_str(), text.length(), font_size, clear);
 }
 
 void facePrintMiddle(const int number, bool clear, uint8_t font_size) {
-  facePrintMiddle(std::to_string(number), clear, font_size);
+  char text[16];
+  face_sendText(FACE_PRINT_MIDDLE, text, snprintf(text, sizeof(text), "%d", number), font_size, clear);
 }
 
 void facePrintMiddle(const float number, bool clear, uint8_t font_size) {
-  facePrintMiddle(std::to_string(number), clear, font_size);
+  char text[FACE_TEXT_LENGTH];
+  face_sendText(FACE_PRINT_MIDDLE, text, min(snprintf(text, sizeof(text), "%f", number), FACE_TEXT_LENGTH - 1), font_size, clear);
 }
 
 void facePrintMiddle(const char message, bool clear, uint8_t font_size) {
-  facePrintMiddle(std::string(1, message), clear, font_size);
+  face_sendText(FACE_PRINT_MIDDLE, &message, 1, font_size, clear);
 }
 
 /**
@@ -217,6 +361,7 @@ void facePrintMiddle(const char message, bool clear, uint8_t font_size) {
 void display_clearDisplay() {
   if (!u8g2_initialized) return;
   u8g2.clearBuffer();
+  face_log_shown = false;
 }
 /**
  * @brief Draws a filled rounded rectangle at (x, y) with width w, height h, corner radius r, and color.
@@ -233,15 +378,59 @@ void display_fillRoundRect(int x, int y, int w, int h, int r, int color) {
     r = (h / 2) - 1;
   }
   // check if height and width are valid when calling drawRBox
-  u8g2.drawRBox(x, y, w < 1 ? 1 : w, h < 1 ? 1 : h, r);
+  fill_roundBox(u8g2.getU8g2(), x, y, w < 1 ? 1 : w, h < 1 ? 1 : h, r);
+}
+
+/**
+ * @brief Sends the changed tiles of the back buffer and swaps the buffers, the next frame
+ *        is drawn while this one is on the wire. Each tile row sends one span from its first
+ *        to its last changed tile, a blink or a saccade only transfers the rows the eyes cover.
+ *        The new back buffer starts as a copy of the frame just sent.
+ */
+void display_swap() {
+  if (!u8g2_initialized) return;
+  uint8_t *back = display_frames[display_back];
+  uint8_t *front = display_frames[1 - display_back];
+  if (!display_front_valid) {
+    u8g2.sendBuffer();
+    display_front_valid = true;
+  } else {
+    for (int ty = 0; ty < DISPLAY_TILE_ROWS; ty++) {
+      uint8_t *row = back + ty * SCREEN_WIDTH;
+      uint8_t *front_row = front + ty * SCREEN_WIDTH;
+      int first = -1, last = -1;
+      for (int tx = 0; tx < DISPLAY_TILE_COLUMNS; tx++) {
+        if (memcmp(row + tx * 8, front_row + tx * 8, 8) != 0) {
+          if (first < 0) first = tx;
+          last = tx;
+        }
+      }
+      if (first >= 0) {
+        u8g2.updateDisplayArea(first, ty, last - first + 1, 1);
+      }
+    }
+  }
+  display_frame_fence[display_back] = display_fence();
+
+  // The old front buffer is drawn next, once its own tiles are out
+  display_back = 1 - display_back;
+  display_waitFence(display_frame_fence[display_back]);
+  memcpy(display_frames[display_back], back, DISPLAY_FRAME_SIZE);
+  u8g2.getU8g2()->tile_buf_ptr = display_frames[display_back];
 }
 
 /**
  * @brief Sends the buffer to the display (refreshes the screen).
  */
 void display_display() {
-  if (!u8g2_initialized) return;
-  u8g2.sendBuffer();
+  display_swap();
+}
+
+/**
+ * @brief Forgets what the display shows, the next flush sends the whole buffer.
+ */
+void display_invalidate() {
+  display_front_valid = false;
 }
 
 
@@ -275,111 +464,231 @@ void draw_eyes(bool update) {
 }
 
 
+// ---- Eye animations ---------------------------------------------------------
+// Every animation below only queues an expression and returns. The face task
+// hands it to the animator, and eyes_update() advances the animation by the
+// elapsed time and draws a frame when the eyes changed, so no caller waits
+// for an animation to finish.
+
+static EyeAnimator eyes_animator;
+
 /**
- * @brief Resets both eyes to their default (centered) positions and sizes, then draws them.
- * @param update If true, updates the display after drawing.
+ * @brief State of the eyes at rest, centered on the display.
  */
-void eyes_reset(bool update) {
-  //move eyes to the center of the display, defined by SCREEN_WIDTH, SCREEN_HEIGHT
-  left_eye_height = ref_eye_height;
-  left_eye_width = ref_eye_width;
-  right_eye_height = ref_eye_height;
-  right_eye_width = ref_eye_width;
+static EyeState eyes_referenceState() {
+  EyeState state;
+  state.left.x = SCREEN_WIDTH / 2 - ref_eye_width / 2 - ref_space_between_eye / 2;
+  state.left.y = SCREEN_HEIGHT / 2;
+  state.left.width = ref_eye_width;
+  state.left.height = ref_eye_height;
+  state.right = state.left;
+  state.right.x = SCREEN_WIDTH / 2 + ref_eye_width / 2 + ref_space_between_eye / 2;
+  state.radius = ref_corner_radius;
+  state.lid = 0;
+  return state;
+}
 
-  left_eye_x = SCREEN_WIDTH / 2 - ref_eye_width / 2 - ref_space_between_eye / 2;
-  left_eye_y = SCREEN_HEIGHT / 2;
-  right_eye_x = SCREEN_WIDTH / 2 + ref_eye_width / 2 + ref_space_between_eye / 2;
-  right_eye_y = SCREEN_HEIGHT / 2;
+/**
+ * @brief State of the sleeping eyes, thin horizontal lines.
+ */
+static EyeState eyes_sleepState() {
+  EyeState state = eyes_referenceState();
+  state.left.height = 2;
+  state.right.height = 2;
+  state.radius = 0;
+  return state;
+}
 
-  corner_radius = ref_corner_radius;
+/**
+ * @brief Offset of both eyes for relative keyframes.
+ */
+static EyeState eyes_offset(int dx, int dy, int dw, int dh) {
+  EyeState state = {};
+  state.left = {(int16_t)dx, (int16_t)dy, (int16_t)dw, (int16_t)dh};
+  state.right = state.left;
+  return state;
+}
 
-  draw_eyes(update);
+static void eyes_addKeyframe(EyeExpression &expression, const EyeState &state, uint16_t durationMs, EYE_EASING easing, EYE_KEYFRAME_MODE mode) {
+  if (expression.count < EYES_MAX_KEYFRAMES) {
+    expression.keyframes[expression.count++] = {state, durationMs, (uint8_t)easing, (uint8_t)mode};
+  }
 }
 
+// Lower lids of the happy eyes at the reference size, rasterized once by initialize_face()
+static ColumnSprite eyes_lid_sprites[2];
+
 /**
- * @brief Performs a blink animation by shrinking and restoring the eyes.
- * @param speed The speed of the blink (default: 12).
+ * @brief Draws the lower lid of one eye with U8g2, a triangle over the lower part of the eye.
  */
-void eyes_blink(int speed) {
-  eyes_reset(false);
+static void eyes_drawLidTriangle(const EyeState &state, bool right, int color) {
+  int offset = ref_eye_height / 2 - state.lid;
+  const EyeShape &l = state.left;
+  const EyeShape &r = state.right;
+  if (!right) {
+    display_fillTriangle(l.x - l.width / 2 - 1, l.y + offset, l.x + l.width / 2 + 1, l.y + 5 + offset, l.x - l.width / 2 - 1, l.y + l.height + offset, color);
+  } else {
+    display_fillTriangle(r.x + r.width / 2 + 1, r.y + offset, r.x - l.width / 2 - 2, r.y + 5 + offset, r.x + r.width / 2 + 1, r.y + r.height + offset, color);
+  }
+}
 
-  draw_eyes(true);
+/**
+ * @brief Rasterizes the lids of the reference eyes into sprites. The lids only move up and down
+ *        while the eyes keep their size, so the happy eyes are drawn from the sprites.
+ */
+static void eyes_buildLidSprites() {
+  EyeState state = eyes_referenceState();
+  state.lid = ref_eye_height / 2;
+  // High enough that the whole lid is on the display
+  state.left.y = (SCREEN_HEIGHT - ref_eye_height) / 2;
+  state.right.y = state.left.y;
+  for (int side = 0; side < 2; side++) {
+    const EyeShape &eye = side == 0 ? state.left : state.right;
+    u8g2.clearBuffer();
+    eyes_drawLidTriangle(state, side == 1, COLOR_WHITE);
+    eyes_lid_sprites[side].capture(u8g2.getU8g2(), eye.x, eye.y);
+  }
+  u8g2.clearBuffer();
+}
 
+/**
+ * @brief Draws the lower lids of the happy eyes, from the sprites if the eyes have the reference size.
+ */
+static void eyes_drawLids(const EyeState &state) {
+  bool reference = state.left.width == ref_eye_width && state.left.height == ref_eye_height
+                   && state.right.width == ref_eye_width && state.right.height == ref_eye_height;
+  int offset = ref_eye_height / 2 - state.lid;
+  for (int side = 0; side < 2; side++) {
+    const EyeShape &eye = side == 0 ? state.left : state.right;
+    if (reference && eyes_lid_sprites[side].isValid()) {
+      u8g2.setDrawColor(COLOR_BLACK);
+      eyes_lid_sprites[side].draw(u8g2.getU8g2(), eye.x, eye.y + offset);
+    } else {
+      eyes_drawLidTriangle(state, side == 1, COLOR_BLACK);
+    }
+  }
+}
 
-  for (int i = 0; i < 3; i++) {
-    left_eye_height = left_eye_height - speed;
-    right_eye_height = right_eye_height - speed;
+/**
+ * @brief Draws both eyes of an animation state, including the lower lids of the happy eyes.
+ */
+static void eyes_draw(const EyeState &state) {
+  left_eye_x = state.left.x;
+  left_eye_y = state.left.y;
+  left_eye_width = state.left.width;
+  left_eye_height = state.left.height;
+  right_eye_x = state.right.x;
+  right_eye_y = state.right.y;
+  right_eye_width = state.right.width;
+  right_eye_height = state.right.height;
+  corner_radius = state.radius;
+  draw_eyes(false);
+  if (state.lid > 0) {
+    //draw inverted triangle over eye lower part
+    eyes_drawLids(state);
+  }
+}
 
-    left_eye_width = left_eye_width + 3;
-    right_eye_width = right_eye_width + 3;
-  draw_eyes(true);
-    delay(1);
+/**
+ * @brief Advances the eye animation to now and draws a frame if the eyes changed. Render task only.
+ * @return True if a frame was drawn.
+ */
+static bool eyes_update(uint32_t now) {
+  if (!u8g2_initialized) return false;
+  bool drawn = eyes_animator.update(now);
+  if (drawn) {
+    eyes_draw(eyes_animator.getState());
+    display_display();
   }
-  for (int i = 0; i < 3; i++) {
-    left_eye_height = left_eye_height + speed;
-    right_eye_height = right_eye_height + speed;
-    left_eye_width = left_eye_width - 3;
-    right_eye_width = right_eye_width - 3;
-  draw_eyes(true);
-    delay(1);
+  face_animating.store(eyes_animator.isAnimating());
+  return drawn;
+}
+
+/**
+ * @brief Checks if an eye expression is playing or queued.
+ */
+bool eyes_isAnimating() {
+  return face_pending_expressions.load() > 0 || face_animating.load();
+}
+
+/**
+ * @brief Queues an expression for the render task.
+ */
+bool eyes_play(const EyeExpression &expression, bool interrupt) {
+  if (face_queue == NULL) return false;
+  FaceCommand command;
+  command.type = FACE_EXPRESSION;
+  command.interrupt = interrupt;
+  command.expression = expression;
+  face_pending_expressions++;
+  xSemaphoreTake(face_queue_lock, portMAX_DELAY);
+  bool sent = xQueueSend(face_queue, &command, 0) == pdTRUE;
+  xSemaphoreGive(face_queue_lock);
+  if (!sent) {
+    face_pending_expressions--;
   }
+  return sent;
 }
 
+/**
+ * @brief Resets both eyes to their default (centered) positions and sizes.
+ * @param update If true, the eyes move there in a short tween, otherwise they jump.
+ */
+void eyes_reset(bool update) {
+  //move eyes to the center of the display, defined by SCREEN_WIDTH, SCREEN_HEIGHT
+  EyeExpression expression = {};
+  eyes_addKeyframe(expression, eyes_referenceState(), update ? 60 : 0, EASE_OUT, EYE_ABSOLUTE);
+  eyes_play(expression);
+}
 
+/**
+ * @brief Performs a blink animation by shrinking and restoring the eyes.
+ * @param speed The speed of the blink (default: 12), the eyes close by 3 * speed pixels, at most to a line.
+ */
+void eyes_blink(int speed) {
+  // Blink from the default eyes, like eyes_reset(false), so the eyes never close past a line
+  EyeState open = eyes_referenceState();
+  EyeState closed = open;
+  closed.left.height = closed.right.height = max(ref_eye_height - 3 * speed, 1);
+  closed.left.width = closed.right.width = ref_eye_width + 9;
+  EyeExpression expression = {};
+  eyes_addKeyframe(expression, open, 0, EASE_LINEAR, EYE_ABSOLUTE);
+  eyes_addKeyframe(expression, closed, 60, EASE_IN, EYE_ABSOLUTE);
+  eyes_addKeyframe(expression, open, 60, EASE_OUT, EYE_ABSOLUTE);
+  eyes_play(expression);
+}
 
 /**
  * @brief Sets the eyes to a "sleeping" state (thin horizontal lines).
  */
 void eyes_sleep() {
-  eyes_reset(false);
-
-  left_eye_height = 2;
-  left_eye_width = ref_eye_width;
-  right_eye_height = 2;
-  right_eye_width = ref_eye_width;
-
-
-  corner_radius = 0;
-  draw_eyes(true);
+  EyeExpression expression = {};
+  eyes_addKeyframe(expression, eyes_sleepState(), 150, EASE_IN, EYE_ABSOLUTE);
+  eyes_play(expression);
 }
+
 /**
  * @brief Wakes up the eyes with an opening animation.
  */
 void eyes_wakeup() {
-  eyes_reset(false);
-
-  eyes_sleep();
-
-  for (int h = 2; h <= ref_eye_height; h += 2) {
-    left_eye_height = h;
-    right_eye_height = h;
-    corner_radius = h;
-    if (corner_radius > ref_corner_radius) {
-      corner_radius = ref_corner_radius;
-    }
-    draw_eyes(true);
-  }
+  EyeExpression expression = {};
+  eyes_addKeyframe(expression, eyes_sleepState(), 0, EASE_LINEAR, EYE_ABSOLUTE);
+  eyes_addKeyframe(expression, eyes_referenceState(), 300, EASE_OUT, EYE_ABSOLUTE);
+  eyes_play(expression);
 }
 
-
 /**
- * @brief Draws a "happy" eye expression by overlaying triangles on the lower part of the eyes.
+ * @brief Draws a "happy" eye expression by raising the lower lids for a second.
  */
 void eyes_happy() {
-  eyes_reset(false);
-  //draw inverted triangle over eye lower part
-  int offset = ref_eye_height / 2;
-  for (int i = 0; i < 10; i++) {
-    display_fillTriangle(left_eye_x - left_eye_width / 2 - 1, left_eye_y + offset, left_eye_x + left_eye_width / 2 + 1, left_eye_y + 5 + offset, left_eye_x - left_eye_width / 2 - 1, left_eye_y + left_eye_height + offset, COLOR_BLACK);
-    display_fillTriangle(right_eye_x + right_eye_width / 2 + 1, right_eye_y + offset, right_eye_x - left_eye_width / 2 - 2, right_eye_y + 5 + offset, right_eye_x + right_eye_width / 2 + 1, right_eye_y + right_eye_height + offset, COLOR_BLACK);
-    offset -= 2;
-    display_display();
-    delay(1);
-  }
-
-
-  display_display();
-  delay(1000);
+  EyeState happy = eyes_referenceState();
+  happy.lid = ref_eye_height / 2;
+  EyeExpression expression = {};
+  eyes_addKeyframe(expression, eyes_referenceState(), 60, EASE_OUT, EYE_ABSOLUTE);
+  eyes_addKeyframe(expression, happy, 150, EASE_OUT, EYE_ABSOLUTE);
+  eyes_addKeyframe(expression, happy, 1000, EASE_LINEAR, EYE_ABSOLUTE);
+  eyes_addKeyframe(expression, eyes_referenceState(), 150, EASE_IN_OUT, EYE_ABSOLUTE);
+  eyes_play(expression);
 }
 
 /**
@@ -396,30 +705,12 @@ void eyes_saccade(int direction_x, int direction_y) {
   int direction_y_movement_amplitude = 6;
   int blink_amplitude = 8;
 
-  for (int i = 0; i < 1; i++) {
-    left_eye_x += direction_x_movement_amplitude * direction_x;
-    right_eye_x += direction_x_movement_amplitude * direction_x;
-    left_eye_y += direction_y_movement_amplitude * direction_y;
-    right_eye_y += direction_y_movement_amplitude * direction_y;
-
-    right_eye_height -= blink_amplitude;
-    left_eye_height -= blink_amplitude;
-  draw_eyes(true);
-    delay(1);
-  }
-
-  for (int i = 0; i < 1; i++) {
-    left_eye_x += direction_x_movement_amplitude * direction_x;
-    right_eye_x += direction_x_movement_amplitude * direction_x;
-    left_eye_y += direction_y_movement_amplitude * direction_y;
-    right_eye_y += direction_y_movement_amplitude * direction_y;
-
-    right_eye_height += blink_amplitude;
-    left_eye_height += blink_amplitude;
-
-  draw_eyes(true);
-    delay(1);
-  }
+  int dx = direction_x_movement_amplitude * direction_x;
+  int dy = direction_y_movement_amplitude * direction_y;
+  EyeExpression expression = {};
+  eyes_addKeyframe(expression, eyes_offset(dx, dy, 0, -blink_amplitude), 30, EASE_IN, EYE_RELATIVE);
+  eyes_addKeyframe(expression, eyes_offset(2 * dx, 2 * dy, 0, 0), 30, EASE_OUT, EYE_RELATIVE);
+  eyes_play(expression);
 }
 
 /**
@@ -442,75 +733,27 @@ void eyes_move_big(int direction) {
   //direction == -1 :  move left
   //direction == 1 :  move right
 
-  int direction_oversize = 1;
-  int direction_movement_amplitude = 2;
-  int blink_amplitude = 5;
-
-  for (int i = 0; i < 3; i++) {
-    left_eye_x += direction_movement_amplitude * direction;
-    right_eye_x += direction_movement_amplitude * direction;
-    right_eye_height -= blink_amplitude;
-    left_eye_height -= blink_amplitude;
-    if (direction > 0) {
-      right_eye_height += direction_oversize;
-      right_eye_width += direction_oversize;
-    } else {
-      left_eye_height += direction_oversize;
-      left_eye_width += direction_oversize;
-    }
-
-  draw_eyes(true);
-    delay(1);
-  }
-  for (int i = 0; i < 3; i++) {
-    left_eye_x += direction_movement_amplitude * direction;
-    right_eye_x += direction_movement_amplitude * direction;
-    right_eye_height += blink_amplitude;
-    left_eye_height += blink_amplitude;
-    if (direction > 0) {
-      right_eye_height += direction_oversize;
-      right_eye_width += direction_oversize;
-    } else {
-      left_eye_height += direction_oversize;
-      left_eye_width += direction_oversize;
-    }
-  draw_eyes(true);
-    delay(1);
-  }
-
-  delay(1000);
-
-  for (int i = 0; i < 3; i++) {
-    left_eye_x -= direction_movement_amplitude * direction;
-    right_eye_x -= direction_movement_amplitude * direction;
-    right_eye_height -= blink_amplitude;
-    left_eye_height -= blink_amplitude;
-    if (direction > 0) {
-      right_eye_height -= direction_oversize;
-      right_eye_width -= direction_oversize;
-    } else {
-      left_eye_height -= direction_oversize;
-      left_eye_width -= direction_oversize;
-    }
-  draw_eyes(true);
-    delay(1);
-  }
-  for (int i = 0; i < 3; i++) {
-    left_eye_x -= direction_movement_amplitude * direction;
-    right_eye_x -= direction_movement_amplitude * direction;
-    right_eye_height += blink_amplitude;
-    left_eye_height += blink_amplitude;
-    if (direction > 0) {
-      right_eye_height -= direction_oversize;
-      right_eye_width -= direction_oversize;
-    } else {
-      left_eye_height -= direction_oversize;
-      left_eye_width -= direction_oversize;
-    }
-  draw_eyes(true);
-    delay(1);
-  }
-  eyes_reset(true);
+  int direction_oversize = 3;
+  int direction_movement_amplitude = 6;
+  int blink_amplitude = 15;
+
+  // Half way the eyes blink, the eye on the side of the movement grows
+  EyeState half = eyes_offset(direction_movement_amplitude * direction, 0, 0, -blink_amplitude);
+  EyeState full = eyes_offset(2 * direction_movement_amplitude * direction, 0, 0, 0);
+  EyeShape &half_outer = direction > 0 ? half.right : half.left;
+  EyeShape &full_outer = direction > 0 ? full.right : full.left;
+  half_outer.width += direction_oversize;
+  half_outer.height += direction_oversize;
+  full_outer.width += 2 * direction_oversize;
+  full_outer.height += 2 * direction_oversize;
+
+  EyeExpression expression = {};
+  eyes_addKeyframe(expression, half, 50, EASE_IN, EYE_RELATIVE);
+  eyes_addKeyframe(expression, full, 50, EASE_OUT, EYE_RELATIVE);
+  eyes_addKeyframe(expression, full, 1000, EASE_LINEAR, EYE_RELATIVE);
+  eyes_addKeyframe(expression, half, 50, EASE_IN, EYE_RELATIVE);
+  eyes_addKeyframe(expression, eyes_referenceState(), 50, EASE_OUT, EYE_ABSOLUTE);
+  eyes_play(expression);
 }
 
 
@@ -541,10 +784,14 @@ void launch_animation_with_index(int animation_index) {
     case 3:
       eyes_move_left_big();
       break;
-    case 4:
+    case 4: {
       eyes_blink(12);
-      delay(1000);
+      // Keep the eyes open for a second before the next animation
+      EyeExpression hold = {};
+      eyes_addKeyframe(hold, eyes_offset(0, 0, 0, 0), 1000, EASE_LINEAR, EYE_RELATIVE);
+      eyes_play(hold);
       break;
+    }
     case 5:
       eyes_blink(12);
       break;
@@ -561,9 +808,7 @@ void launch_animation_with_index(int animation_index) {
         int dir_x = random(-1, 2);
         int dir_y = random(-1, 2);
         eyes_saccade(dir_x, dir_y);
-        delay(1);
         eyes_saccade(-dir_x, -dir_y);
-        delay(1);
       }
       break;
   }
@@ -573,10 +818,11 @@ void launch_animation_with_index(int animation_index) {
 
 /**
  * @brief Demo/test function for face emoji animations. Cycles animations in demo mode or responds to serial commands.
+ *        Call it from a loop, the face task plays the animations.
  */
 void testFaceEmoji() {
 
-  if (demo_mode == 1) {
+  if (demo_mode == 1 && !eyes_isAnimating()) {
     // cycle animations
     launch_animation_with_index(current_animation_index++);
     if (current_animation_index > max_animation_index) {
@@ -604,64 +850,131 @@ void testFaceEmoji() {
 }
 
 /**
- * @brief FreeRTOS task handle for running face emoji animations and handling serial commands.
+ * @brief FreeRTOS task handle of the face render task.
  */
-TaskHandle_t FaceEmojiTask_Handle;
+TaskHandle_t FaceEmojiTask_Handle = NULL;
 
 /**
- * @brief FreeRTOS task for running face emoji animations and handling serial commands.
+ * @brief Takes the next face command if it can run now. An expression that does not
+ *        interrupt stays in the face queue while the animator queue is full, so the face
+ *        queue (FACE_QUEUE_LENGTH) buffers the expressions the animator (EYES_QUEUE_LENGTH)
+ *        has no room for, and the commands behind it keep their order. Render task only.
+ */
+static bool face_receive(FaceCommand &command, TickType_t wait) {
+  if (xQueuePeek(face_queue, &command, wait) != pdTRUE) {
+    return false;
+  }
+  if (command.type == FACE_EXPRESSION && !command.interrupt &&
+      eyes_animator.getQueued() >= EYES_QUEUE_LENGTH) {
+    return false;
+  }
+  // Only this task receives, so the peeked command is the one taken
+  return xQueueReceive(face_queue, &command, 0) == pdTRUE;
+}
+
+/**
+ * @brief Draws one queued face command. Render task only.
+ */
+static void face_execute(FaceCommand &command) {
+  switch (command.type) {
+    case FACE_EXPRESSION:
+      eyes_animator.play(command.expression, command.interrupt);
+      face_animating.store(true);
+      face_pending_expressions--;
+      break;
+    case FACE_PRINT:
+      face_drawPrint(command.text, command.font_size, command.clear);
+      break;
+    case FACE_PRINT_MIDDLE:
+      face_drawPrintMiddle(command.text, command.clear, command.font_size);
+      break;
+  }
+}
+
+/**
+ * @brief FreeRTOS task that owns the display. Draws the queued commands and plays the eye
+ *        animations at EYES_FRAME_MS, and sleeps on the queue while the eyes are still.
  */
 void FaceEmojiTask(void *parameter) {
-  Serial.print("Task2 running on core ");
-  Serial.println(xPortGetCoreID());
+  FaceCommand command;
+  const TickType_t frameTicks = max(pdMS_TO_TICKS(EYES_FRAME_MS), (TickType_t)1);
+  TickType_t lastFrame = xTaskGetTickCount();
   for (;;) {
-
-    if (demo_mode == 1) {
-      // cycle animations
-      launch_animation_with_index(current_animation_index++);
-      if (current_animation_index > max_animation_index) {
-        current_animation_index = 0;
-      }
+    TickType_t wait = portMAX_DELAY;
+    if (eyes_animator.isAnimating()) {
+      TickType_t elapsed = xTaskGetTickCount() - lastFrame;
+      wait = elapsed < frameTicks ? frameTicks - elapsed : 0;
     }
-
-
-    //send "Ax" for animation x  (ex. A2 will launch animation 2)
-    if (Serial.available()) {
-      String data = Serial.readString();
-      data.trim();
-      char cmd = data[0];
-
-      if (cmd == 'A') {
-        demo_mode = 0;
-
-        String arg = data.substring(1, data.length());
-        int anim = arg.toInt();
-        launch_animation_with_index(anim);
-        Serial.print(cmd);
-        Serial.print(arg);
-      }
+    if (face_receive(command, wait)) {
+      face_execute(command);
     }
+    face_update(millis());
+    lastFrame = xTaskGetTickCount();
+  }
+}
+
+/**
+ * @brief Draws everything that is queued, then the eye frame due at now.
+ */
+bool face_update(uint32_t now) {
+  if (face_queue == NULL) return false;
+  FaceCommand command;
+  bool drawn = false;
+  while (face_receive(command, 0)) {
+    face_execute(command);
+    drawn |= command.type != FACE_EXPRESSION;
   }
+  return eyes_update(now) || drawn;
 }
 
 /**
  * @brief Initializes the face emoji system, display, and starts the animation task.
  */
-void initialize_face() {
+void initialize_face(bool start_task) {
+  if (face_queue != NULL) {
+    return;
+  }
   //initialize the u8g2 lib.
+  display_frames[0] = u8g2.getBufferPtr();
+#ifdef U8X8_HAVE_ESP32_DMA_SPI
+  // Queue the SPI transfers to the DMA, the frame buffers themselves are sent without a copy
+  u8g2.getU8x8()->byte_cb = u8x8_byte_esp32_dma_spi;
+  u8x8_byte_esp32_dma_spi_zero_copy(display_frames[0], DISPLAY_FRAME_SIZE);
+  u8x8_byte_esp32_dma_spi_zero_copy(display_frames[1], DISPLAY_FRAME_SIZE);
+#endif
   u8g2.begin();
+#ifdef U8X8_HAVE_ESP32_DMA_SPI
+  // begin() clears the display from the first frame, which no fence covers yet.
+  // Let the transfer finish before anything is drawn into it.
+  u8x8_byte_esp32_dma_spi_wait();
+#endif
+  // Lines and boxes of every U8g2 drawing function are filled a page row at a time
+  fill_install(u8g2.getU8g2());
+#if FACE_GLYPH_CACHE
+  // Rasterize the cached fonts while the buffer is still empty
+  for (size_t i = 0; i < sizeof(face_cached_fonts) / sizeof(face_cached_fonts[0]); i++) {
+    face_glyph_caches[i].build(u8g2.getU8g2(), face_cached_fonts[i]);
+  }
+#endif
   u8g2_initialized = true;
+  display_invalidate();
+  eyes_buildLidSprites();
 
   //clear screen and display startup info.
-  display_clearDisplay();
-  eyes_sleep();
+  eyes_animator.reset(eyes_sleepState());
+  eyes_draw(eyes_animator.getState());
   u8g2.setFont(u8g2_font_ncenB10_tr);
   u8g2.drawStr(0, 10, "CHIKO");
 
   display_display();
 
-  // Create FaceEmojiTask on core 1
-  // xTaskCreatePinnedToCore(
-  //   FaceEmojiTask, "FaceEmojiTask", 10000, NULL, 1, &FaceEmojiTask_Handle, 1);
+  // From here on only the face task draws
+  face_queue_lock = xSemaphoreCreateMutex();
+  face_queue = xQueueCreate(FACE_QUEUE_LENGTH, sizeof(FaceCommand));
+  if (!start_task) {
+    return;
+  }
+  xTaskCreatePinnedToCore(
+    FaceEmojiTask, "FaceEmojiTask", FACE_TASK_STACK_SIZE, NULL, FACE_TASK_PRIORITY, &FaceEmojiTask_Handle, FACE_TASK_CORE);
 }
 
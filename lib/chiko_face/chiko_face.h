@@ -1,9 +1,29 @@
 #ifndef __CHIKO_FACEEMOJI__
 #define __CHIKO_FACEEMOJI__
 
-#include <SPI.h>
 #include <U8g2lib.h>
 #include <string>
+#include "chiko_eyes.h"
+
+/*
+    Face render task
+    A single task owns u8g2 and the display. The face functions below only copy
+    a command into a fixed size queue and return, so the motion and control
+    tasks never wait on the SPI bus. A command that does not fit in the queue
+    is dropped.
+*/
+#ifndef FACE_TASK_CORE
+#define FACE_TASK_CORE         1     // Core the face task is pinned to
+#endif
+#define FACE_TASK_PRIORITY     1
+#define FACE_TASK_STACK_SIZE   4096
+#define FACE_QUEUE_LENGTH      8     // Commands waiting for the face task
+#define FACE_TEXT_LENGTH       32    // Characters of one print command, longer text takes several
+
+// 1 to draw the text fonts from pre-rasterized glyphs (about 6 kB of RAM), 0 to decode them with U8g2
+#ifndef FACE_GLYPH_CACHE
+#define FACE_GLYPH_CACHE       1
+#endif
 
 
 
@@ -29,10 +49,24 @@ void display_clearDisplay();
 void display_fillRoundRect();
 
 /**
- * @brief Sends the buffer to the display (refreshes the screen).
+ * @brief Sends the buffer to the display (refreshes the screen). Only the 8x8 tiles
+ *        that changed since the last refresh are transferred. Same as display_swap().
  */
 void display_display();
 
+/**
+ * @brief Sends the drawn frame and swaps the front and back buffers. Returns while the frame
+ *        is still on the wire, the next frame can be drawn right away. The new back buffer
+ *        starts as a copy of the frame just sent, so drawing on top of it keeps working.
+ */
+void display_swap();
+
+/**
+ * @brief Marks the whole display as changed, the next display_display() sends the full buffer.
+ *        Call it when the display content was changed outside of the face module.
+ */
+void display_invalidate();
+
 /**
  * @brief Draws a filled triangle with the given coordinates and color.
  */
@@ -45,8 +79,23 @@ void display_fillTriangle(int x0, int y0, int x1, int y1, int x2, int y2, int co
 void draw_eyes(bool update);
 
 /**
- * @brief Resets both eyes to their default (centered) positions and sizes, then draws them.
- * @param update If true, updates the display after drawing.
+ * @brief Checks if an eye expression is playing or queued.
+ */
+bool eyes_isAnimating();
+
+/**
+ * @brief Plays an expression after the queued ones, or blends it in right away.
+ *        The eye animations below all queue an expression through it.
+ * @param expression The expression to play.
+ * @param interrupt If true, the queued expressions are dropped.
+ * @return False if the face queue is full. Expressions wait there while the animator
+ *         queue (EYES_QUEUE_LENGTH) is full, so none is dropped once queued.
+ */
+bool eyes_play(const EyeExpression &expression, bool interrupt = false);
+
+/**
+ * @brief Resets both eyes to their default (centered) positions and sizes.
+ * @param update If true, the eyes move there in a short tween, otherwise they jump.
  */
 void eyes_reset(bool update);
 
@@ -74,7 +123,7 @@ void eyes_wakeup();
 void eyes_saccade(int direction_x, int direction_y);
 
 /**
- * @brief Draws a "happy" eye expression by overlaying triangles on the lower part of the eyes.
+ * @brief Draws a "happy" eye expression by raising the lower lids for a second.
  */
 void eyes_happy();
 
@@ -101,9 +150,21 @@ void eyes_move_big(int direction);
 void launch_animation_with_index(int animation_index);
 
 /**
- * @brief Initializes the face emoji system, display, and starts the animation task.
+ * @brief Initializes the face emoji system, display, and starts the face task on FACE_TASK_CORE.
+ *        From then on only the face task draws, the display_ and draw_ functions must not be
+ *        called from other tasks.
+ * @param start_task False to draw without the face task, the caller then calls face_update()
+ *        itself, e.g. a host harness with its own clock.
+ */
+void initialize_face(bool start_task = true);
+
+/**
+ * @brief Draws the queued face commands and the eye frame due at now. The face task calls it
+ *        every frame, call it only if the face was initialized without the task.
+ * @param now Current time in mS, e.g. millis().
+ * @return True if something was drawn and sent to the display.
  */
-void initialize_face();
+bool face_update(uint32_t now);
 
 
 /**
@@ -0,0 +1,91 @@
+#include "chiko_facelog.h"
+
+FaceLog::FaceLog() {
+  RowStart[0] = 0;
+}
+
+void FaceLog::newRow(uint32_t start) {
+  RowStart[Rows % FACE_LOG_ROWS] = start;
+  Rows++;
+  RowWidth = 0;
+}
+
+/*
+    Wrap the character just appended, at End - 1
+    */
+void FaceLog::layout(char c) {
+  if (c == '\n') {
+    newRow(End);
+    return;
+  }
+  uint8_t glyph = (uint8_t)c - FACE_LOG_FIRST_GLYPH;
+  uint8_t advance = glyph < FACE_LOG_GLYPHS ? Advance[glyph] : 0;
+  // A character wider than the display still gets a row of its own
+  if (RowWidth > 0 && RowWidth + advance > Width) {
+    newRow(End - 1);
+  }
+  RowWidth += advance;
+}
+
+void FaceLog::setFont(const uint8_t *advance, uint16_t width) {
+  memcpy(Advance, advance, sizeof(Advance));
+  Width = width;
+
+  // Wrap again from the oldest kept row that is still in the ring
+  uint32_t oldest = Rows > FACE_LOG_ROWS ? Rows - FACE_LOG_ROWS : 0;
+  uint32_t start = RowStart[oldest % FACE_LOG_ROWS];
+  if (End > FACE_LOG_SIZE) {
+    start = max(start, End - FACE_LOG_SIZE);
+  }
+  uint32_t end = End;
+  Rows = oldest;
+  newRow(start);
+  for (End = start; End < end;) {
+    char c = Text[End % FACE_LOG_SIZE];
+    End++;
+    layout(c);
+  }
+  FirstChanged = oldest;
+}
+
+void FaceLog::append(const char *text, size_t length) {
+  FirstChanged = min(FirstChanged, Rows - 1);
+  for (size_t i = 0; i < length; i++) {
+    Text[End % FACE_LOG_SIZE] = text[i];
+    End++;
+    layout(text[i]);
+  }
+}
+
+uint32_t FaceLog::getRows(void) {
+  return Rows;
+}
+
+size_t FaceLog::getRow(uint32_t row, char *buffer, size_t size) {
+  if (size == 0) {
+    return 0;
+  }
+  size_t length = 0;
+  if (row < Rows && row + FACE_LOG_ROWS >= Rows) {
+    uint32_t start = RowStart[row % FACE_LOG_ROWS];
+    uint32_t end = (row + 1 < Rows) ? RowStart[(row + 1) % FACE_LOG_ROWS] : End;
+    if (End > FACE_LOG_SIZE) {
+      // The start of the row was overwritten
+      start = max(start, End - FACE_LOG_SIZE);
+    }
+    if (end > start && Text[(end - 1) % FACE_LOG_SIZE] == '\n') {
+      end--;
+    }
+    while (start < end && length < size - 1) {
+      buffer[length++] = Text[start++ % FACE_LOG_SIZE];
+    }
+  }
+  buffer[length] = '\0';
+  return length;
+}
+
+uint32_t FaceLog::takeChanges(void) {
+  uint32_t first = min(FirstChanged, Rows);
+  FirstChanged = UINT32_MAX;
+  return first;
+}
@@ -0,0 +1,77 @@
+#ifndef __CHIKO_FACELOG__
+#define __CHIKO_FACELOG__
+
+#include <Arduino.h>
+
+/*
+    Text log of the face
+    The text lives in a fixed size character ring and is wrapped into display
+    rows while it is appended, using a table of glyph advances of the current
+    font. Appending a character costs a table lookup, nothing is measured
+    again and nothing is allocated. The renderer asks which rows changed and
+    only draws those.
+*/
+#define FACE_LOG_SIZE         512   // Characters kept, the oldest are overwritten
+#define FACE_LOG_ROWS         8     // Display rows kept, at least as many as fit on the display
+#define FACE_LOG_FIRST_GLYPH  32    // ' ', first glyph of the advance table
+#define FACE_LOG_GLYPHS       95    // ' ' to '~', other characters have no width
+
+/**
+ * @class FaceLog
+ * @brief Character ring with incremental line wrapping.
+ *        Not thread safe, the face task owns the log.
+ */
+class FaceLog{
+    private:
+        char Text[FACE_LOG_SIZE];
+        uint32_t End = 0;                       // Characters ever appended, the ring index is End % FACE_LOG_SIZE
+        uint32_t RowStart[FACE_LOG_ROWS];       // Start of each kept row, indexed by row % FACE_LOG_ROWS
+        uint32_t Rows = 1;                      // Rows ever started, the last one is being appended to
+        uint32_t FirstChanged = 0;              // First row changed since the last takeChanges()
+        uint16_t RowWidth = 0;                  // Width of the last row [px]
+        uint16_t Width = 128;                   // Width rows wrap at [px]
+        uint8_t Advance[FACE_LOG_GLYPHS] = {};  // Advance of each glyph [px]
+
+        void layout(char c);
+        void newRow(uint32_t start);
+
+    public:
+        FaceLog();
+
+        /**
+         * @brief Set the glyph advances of the font and wrap the kept text again.
+         * @param advance Advance of the glyphs ' ' to '~' in pixels, FACE_LOG_GLYPHS entries.
+         * @param width Width rows wrap at in pixels.
+         */
+        void setFont(const uint8_t *advance, uint16_t width);
+
+        /**
+         * @brief Append text, '\n' starts a new row.
+         * @param text The text.
+         * @param length Number of characters of text.
+         */
+        void append(const char *text, size_t length);
+
+        /**
+         * @brief Get the number of rows ever started, the last one is being appended to.
+         *        Only the last FACE_LOG_ROWS rows can be read.
+         */
+        uint32_t getRows(void);
+
+        /**
+         * @brief Copy the text of a row, without the newline.
+         * @param row The row, between getRows() - FACE_LOG_ROWS and getRows() - 1.
+         * @param buffer Buffer for the null terminated text.
+         * @param size Size of the buffer, longer rows are cut.
+         * @return Number of characters copied.
+         */
+        size_t getRow(uint32_t row, char *buffer, size_t size);
+
+        /**
+         * @brief Get the first row changed since the last call. Rows before it are
+         *        drawn as they were.
+         */
+        uint32_t takeChanges(void);
+};
+
+#endif
@@ -0,0 +1,248 @@
+#include "chiko_glyphcache.h"
+#include <string.h>
+#include <chiko_fill.h>
+
+// Font internals of U8g2, not in its public header
+extern "C" {
+const uint8_t *u8g2_font_get_glyph_data(u8g2_t *u8g2, uint16_t encoding);
+uint8_t u8g2_font_decode_get_unsigned_bits(u8g2_font_decode_t *f, uint8_t cnt);
+int8_t u8g2_font_decode_get_signed_bits(u8g2_font_decode_t *f, uint8_t cnt);
+u8g2_uint_t u8g2_font_calc_vref_font(u8g2_t *u8g2);
+}
+
+// Where the glyphs are drawn while they are rasterized
+#define GLYPH_CACHE_RASTER_X     16
+#define GLYPH_CACHE_RASTER_Y     40
+
+/*
+    Set the pixels of a bitmap byte to the draw color and, in solid font mode,
+    the rest of the glyph box to the background color
+    */
+static inline void blit(uint8_t *tile, uint8_t bits, uint8_t box, uint8_t color) {
+  if (color) {
+    *tile = (*tile & ~box) | bits;
+  } else {
+    *tile = (*tile | box) & ~bits;
+  }
+}
+
+const GlyphCache::Glyph *GlyphCache::getGlyph(uint8_t c) {
+  uint8_t index = c - GLYPH_CACHE_FIRST_GLYPH;
+  if (index >= GLYPH_CACHE_GLYPHS) {
+    return NULL;
+  }
+  return &Glyphs[index];
+}
+
+/*
+    The atlas matches the memory of the display and the text is only cached glyphs
+    */
+bool GlyphCache::canBlit(u8g2_t *u8g2, const char *text) {
+  if (Font == NULL || Font != u8g2->font || u8g2->draw_color > 1) {
+    return false;
+  }
+  if (!fill_isVerticalTopLsb(u8g2)) {
+    return false;
+  }
+#ifdef U8G2_WITH_FONT_ROTATION
+  if (u8g2->font_decode.dir != 0) {
+    return false;
+  }
+#endif
+#ifdef U8G2_WITH_CLIP_WINDOW_SUPPORT
+  if (u8g2->clip_x0 != 0 || u8g2->clip_y0 != 0 || u8g2->clip_x1 < u8g2->width || u8g2->clip_y1 < u8g2->height) {
+    return false;
+  }
+#endif
+  for (; *text != '\0'; text++) {
+    if (getGlyph(*text) == NULL) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool GlyphCache::build(u8g2_t *u8g2, const uint8_t *font) {
+  Font = NULL;
+  if (!fill_isVerticalTopLsb(u8g2)) {
+    return false;
+  }
+
+  // Draw each glyph alone, in transparent mode only its own pixels are set
+  const uint8_t *userFont = u8g2->font;
+  uint8_t userColor = u8g2->draw_color;
+  uint8_t userTransparent = u8g2->font_decode.is_transparent;
+  u8g2_font_calc_vref_fnptr userVref = u8g2->font_calc_vref;
+  u8g2_SetFont(u8g2, font);
+  u8g2_SetDrawColor(u8g2, 1);
+  u8g2_SetFontMode(u8g2, 1);
+  u8g2->font_calc_vref = u8g2_font_calc_vref_font;
+
+  uint8_t *buffer = u8g2_GetBufferPtr(u8g2);
+  int bufferWidth = u8g2_GetBufferTileWidth(u8g2) * 8;
+  int bufferHeight = u8g2_GetBufferTileHeight(u8g2) * 8;
+  uint16_t atlasSize = 0;
+  bool fits = true;
+  for (int i = 0; i < GLYPH_CACHE_GLYPHS && fits; i++) {
+    Glyph &glyph = Glyphs[i];
+    memset(&glyph, 0, sizeof(glyph));
+    const uint8_t *data = u8g2_font_get_glyph_data(u8g2, GLYPH_CACHE_FIRST_GLYPH + i);
+    if (data == NULL) {
+      continue;
+    }
+    // Glyph header, the same fields u8g2_font_decode_glyph() reads
+    u8g2_font_decode_t *decode = &u8g2->font_decode;
+    decode->decode_ptr = data;
+    decode->decode_bit_pos = 0;
+    glyph.data = data - font;
+    glyph.width = u8g2_font_decode_get_unsigned_bits(decode, u8g2->font_info.bits_per_char_width);
+    glyph.height = u8g2_font_decode_get_unsigned_bits(decode, u8g2->font_info.bits_per_char_height);
+    glyph.x = u8g2_font_decode_get_signed_bits(decode, u8g2->font_info.bits_per_char_x);
+    glyph.y = u8g2_font_decode_get_signed_bits(decode, u8g2->font_info.bits_per_char_y);
+    glyph.advance = u8g2_font_decode_get_signed_bits(decode, u8g2->font_info.bits_per_delta_x);
+    glyph.atlas = atlasSize;
+
+    int columnBytes = (glyph.height + 7) / 8;
+    int left = GLYPH_CACHE_RASTER_X + glyph.x;
+    int top = GLYPH_CACHE_RASTER_Y - (glyph.height + glyph.y);
+    if (atlasSize + glyph.width * columnBytes > GLYPH_CACHE_ATLAS_SIZE
+        || left < 0 || left + glyph.width > bufferWidth || top < 0 || top + glyph.height > bufferHeight) {
+      fits = false;
+      break;
+    }
+
+    u8g2_ClearBuffer(u8g2);
+    u8g2_DrawGlyph(u8g2, GLYPH_CACHE_RASTER_X, GLYPH_CACHE_RASTER_Y, GLYPH_CACHE_FIRST_GLYPH + i);
+    uint8_t *bitmap = &Atlas[atlasSize];
+    memset(bitmap, 0, glyph.width * columnBytes);
+    for (int column = 0; column < glyph.width; column++) {
+      for (int row = 0; row < glyph.height; row++) {
+        int y = top + row;
+        if (buffer[(y >> 3) * bufferWidth + left + column] & (1 << (y & 7))) {
+          bitmap[column * columnBytes + (row >> 3)] |= 1 << (row & 7);
+        }
+      }
+    }
+    atlasSize += glyph.width * columnBytes;
+  }
+
+  u8g2_ClearBuffer(u8g2);
+  if (userFont != NULL) {
+    u8g2_SetFont(u8g2, userFont);
+  } else {
+    u8g2->font = NULL;
+  }
+  u8g2_SetDrawColor(u8g2, userColor);
+  u8g2_SetFontMode(u8g2, userTransparent);
+  u8g2->font_calc_vref = userVref;
+  if (fits) {
+    Font = font;
+  }
+  return fits;
+}
+
+bool GlyphCache::isFor(const uint8_t *font) {
+  return Font != NULL && Font == font;
+}
+
+int8_t GlyphCache::getAdvance(char c) {
+  const Glyph *glyph = getGlyph(c);
+  return glyph != NULL ? glyph->advance : 0;
+}
+
+/*
+    Mirrors u8g2_string_width(): the advances of all glyphs, but the last one only
+    counts up to its right edge. A glyph missing in the font keeps the x offset
+    of the glyph before it, as in U8g2.
+    */
+u8g2_uint_t GlyphCache::getUTF8Width(u8g2_t *u8g2, const char *text) {
+  if (!canBlit(u8g2, text)) {
+    return u8g2_GetUTF8Width(u8g2, text);
+  }
+  u8g2_uint_t width = 0;
+  int8_t advance = 0;
+  uint8_t lastWidth = 0;
+  int8_t lastX = u8g2->glyph_x_offset;
+#ifdef U8G2_BALANCED_STR_WIDTH_CALCULATION
+  int8_t initialX = -64;
+#endif
+  for (; *text != '\0'; text++) {
+    const Glyph *glyph = getGlyph(*text);
+    advance = 0;
+    if (glyph->data != 0) {
+      advance = glyph->advance;
+      lastWidth = glyph->width;
+      lastX = glyph->x;
+    }
+#ifdef U8G2_BALANCED_STR_WIDTH_CALCULATION
+    if (initialX == -64) {
+      initialX = lastX;
+    }
+#endif
+    width += advance;
+  }
+  // Same side effects as u8g2_GetGlyphWidth()
+  u8g2->font_decode.glyph_width = lastWidth;
+  u8g2->glyph_x_offset = lastX;
+  if (lastWidth != 0) {
+    width -= advance;
+    width += lastWidth;
+    width += lastX;
+#ifdef U8G2_BALANCED_STR_WIDTH_CALCULATION
+    if (initialX > 0) {
+      width += initialX;
+    }
+#endif
+  }
+  return width;
+}
+
+u8g2_uint_t GlyphCache::drawUTF8(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, const char *text) {
+  if (!canBlit(u8g2, text)) {
+    return u8g2_DrawUTF8(u8g2, x, y, text);
+  }
+  uint8_t *buffer = u8g2_GetBufferPtr(u8g2);
+  int bufferWidth = u8g2_GetBufferTileWidth(u8g2) * 8;
+  int tileRows = u8g2_GetBufferTileHeight(u8g2);
+  uint8_t color = u8g2->draw_color;
+  bool solid = !u8g2->font_decode.is_transparent;
+  int baseline = (int16_t)(y + u8g2->font_calc_vref(u8g2));
+  int cursor = (int16_t)x;
+
+  for (; *text != '\0'; text++) {
+    const Glyph *glyph = getGlyph(*text);
+    if (glyph->data == 0) {
+      continue;
+    }
+    int columnBytes = (glyph->height + 7) / 8;
+    int left = cursor + glyph->x;
+    int top = baseline - (glyph->height + glyph->y);
+    const uint8_t *bitmap = &Atlas[glyph->atlas];
+    for (int column = 0; column < glyph->width; column++) {
+      int dx = left + column;
+      if (dx < 0 || dx >= bufferWidth) {
+        continue;
+      }
+      for (int k = 0; k < columnBytes; k++) {
+        uint8_t bits = bitmap[column * columnBytes + k];
+        uint8_t box = 0;
+        if (solid) {
+          int rows = glyph->height - 8 * k;
+          box = rows >= 8 ? 0xFF : (1 << rows) - 1;
+        }
+        // Each bitmap byte lands on at most two tile rows of the buffer
+        int row = top + 8 * k;
+        int tile = (row + 256) / 8 - 32;
+        int shift = row & 7;
+        if (tile >= 0 && tile < tileRows) {
+          blit(&buffer[tile * bufferWidth + dx], bits << shift, box << shift, color);
+        }
+        if (shift != 0 && tile + 1 >= 0 && tile + 1 < tileRows) {
+          blit(&buffer[(tile + 1) * bufferWidth + dx], bits >> (8 - shift), box >> (8 - shift), color);
+        }
+      }
+    }
+    cursor += glyph->advance;
+  }
+  return cursor - (int16_t)x;
+}
@@ -0,0 +1,82 @@
+#ifndef __CHIKO_GLYPHCACHE__
+#define __CHIKO_GLYPHCACHE__
+
+#include <Arduino.h>
+#include <clib/u8g2.h>
+
+/*
+    Glyph cache
+    U8g2 finds a glyph by walking the font table and draws it by decoding its
+    run length bitstream, for every character of every string. The cache does
+    both once per font: it keeps the metrics of the printable ASCII glyphs and
+    a 1 bit per pixel atlas laid out like the display buffer (8 pixel high
+    columns), so drawing a glyph is a shift and an OR per column byte.
+    Only full buffer displays with vertical tiles (SSD13xx) at rotation R0 are
+    supported, anything else falls back to U8g2.
+*/
+#define GLYPH_CACHE_FIRST_GLYPH   32     // ' ', first cached glyph
+#define GLYPH_CACHE_GLYPHS        95     // ' ' to '~'
+#define GLYPH_CACHE_ATLAS_SIZE    2048   // [bytes] Enough for fonts up to about 12 pixels
+
+/**
+ * @class GlyphCache
+ * @brief Metrics and pre-rasterized bitmaps of one U8g2 font.
+ */
+class GlyphCache{
+    private:
+        /**
+         * @struct Glyph
+         * @brief Metrics of a glyph and where its bitmap is in the atlas.
+         */
+        struct Glyph {
+            uint16_t data;     // Offset of the glyph in the font, 0 if the font has no such glyph
+            uint16_t atlas;    // Offset of the bitmap in the atlas
+            int8_t x;          // Left of the bitmap from the cursor
+            int8_t y;          // Bottom of the bitmap above the baseline
+            int8_t advance;    // Cursor advance
+            uint8_t width;     // Size of the bitmap in pixels
+            uint8_t height;
+        };
+
+        const uint8_t *Font = NULL;
+        Glyph Glyphs[GLYPH_CACHE_GLYPHS];
+        uint8_t Atlas[GLYPH_CACHE_ATLAS_SIZE];
+
+        const Glyph *getGlyph(uint8_t c);
+        bool canBlit(u8g2_t *u8g2, const char *text);
+
+    public:
+        /**
+         * @brief Measure and rasterize the glyphs of a font. The glyphs are drawn into the
+         *        display buffer, which is cleared afterwards, so build the cache before drawing.
+         * @param u8g2 The display, with a full frame buffer.
+         * @param font The font.
+         * @return False if the font does not fit the atlas, the cache stays empty.
+         */
+        bool build(u8g2_t *u8g2, const uint8_t *font);
+
+        /**
+         * @brief Check if the cache holds a font.
+         */
+        bool isFor(const uint8_t *font);
+
+        /**
+         * @brief Get the cursor advance of a glyph.
+         * @return Advance in pixels, 0 for glyphs that are not cached.
+         */
+        int8_t getAdvance(char c);
+
+        /**
+         * @brief Same as u8g2_GetUTF8Width(), with the current font of u8g2.
+         */
+        u8g2_uint_t getUTF8Width(u8g2_t *u8g2, const char *text);
+
+        /**
+         * @brief Same as u8g2_DrawUTF8(), with the current font, draw color and font mode of u8g2.
+         *        Text with characters outside the cache is drawn by U8g2.
+         * @return Width of the text.
+         */
+        u8g2_uint_t drawUTF8(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, const char *text);
+};
+
+#endif
@@ -0,0 +1,64 @@
+#include "chiko_sprite.h"
+#include <chiko_fill.h>
+
+bool ColumnSprite::capture(u8g2_t *u8g2, int x, int y) {
+  Columns = 0;
+  const uint8_t *buffer = u8g2_GetBufferPtr(u8g2);
+  int bufferWidth = u8g2_GetBufferTileWidth(u8g2) * 8;
+  int bufferHeight = u8g2_GetBufferTileHeight(u8g2) * 8;
+  int first = -1;
+  int last = -1;
+  int8_t top[SPRITE_MAX_COLUMNS];
+  int8_t bottom[SPRITE_MAX_COLUMNS];
+  // Empty until a span is found
+  memset(top, 1, sizeof(top));
+  memset(bottom, 0, sizeof(bottom));
+  for (int column = 0; column < bufferWidth; column++) {
+    int spanTop = -1;
+    int spanBottom = -1;
+    for (int row = 0; row < bufferHeight; row++) {
+      if ((buffer[(row >> 3) * bufferWidth + column] & (1 << (row & 7))) == 0) {
+        continue;
+      }
+      if (spanTop >= 0 && spanBottom != row - 1) {
+        return false;  // A second span
+      }
+      if (spanTop < 0) {
+        spanTop = row;
+      }
+      spanBottom = row;
+    }
+    if (spanTop < 0) {
+      continue;
+    }
+    if (first < 0) {
+      first = column;
+    }
+    if (column - first >= SPRITE_MAX_COLUMNS || spanTop - y < INT8_MIN || spanBottom - y > INT8_MAX) {
+      return false;
+    }
+    top[column - first] = spanTop - y;
+    bottom[column - first] = spanBottom - y;
+    last = column;
+  }
+  if (first < 0 || first - x < INT8_MIN || first - x > INT8_MAX) {
+    return false;
+  }
+  Left = first - x;
+  Columns = last - first + 1;
+  memcpy(Top, top, Columns);
+  memcpy(Bottom, bottom, Columns);
+  return true;
+}
+
+bool ColumnSprite::isValid(void) {
+  return Columns > 0;
+}
+
+void ColumnSprite::draw(u8g2_t *u8g2, int x, int y) {
+  for (int i = 0; i < Columns; i++) {
+    if (Top[i] <= Bottom[i]) {
+      fill_box(u8g2, x + Left + i, y + Top[i], 1, Bottom[i] - Top[i] + 1);
+    }
+  }
+}
@@ -0,0 +1,51 @@
+#ifndef __CHIKO_SPRITE__
+#define __CHIKO_SPRITE__
+
+#include <Arduino.h>
+#include <clib/u8g2.h>
+
+/*
+    Column sprite
+    A shape with a single span of pixels in each column, e.g. the lower lid
+    triangle of the happy eyes. The shape is rasterized once by U8g2 and kept
+    as the top and bottom row of each column, so drawing it again anywhere is
+    one masked span per column instead of rasterizing the polygon each frame.
+*/
+#define SPRITE_MAX_COLUMNS   64
+
+/**
+ * @class ColumnSprite
+ * @brief Spans of a shape, relative to an origin.
+ */
+class ColumnSprite{
+    private:
+        int8_t Left = 0;                      // First column from the origin
+        uint8_t Columns = 0;                  // 0 if nothing was captured
+        int8_t Top[SPRITE_MAX_COLUMNS];       // Rows from the origin, Top > Bottom for an empty column
+        int8_t Bottom[SPRITE_MAX_COLUMNS];
+
+    public:
+        /**
+         * @brief Capture the pixels set in the display buffer, e.g. right after drawing the shape
+         *        alone into a cleared buffer.
+         * @param x Origin of the sprite in the buffer.
+         * @param y
+         * @return False if a column has more than one span or the shape is too wide, the sprite
+         *         stays empty.
+         */
+        bool capture(u8g2_t *u8g2, int x, int y);
+
+        /**
+         * @brief Check if a shape was captured.
+         */
+        bool isValid(void);
+
+        /**
+         * @brief Draw the sprite with the current draw color, clipped to the display.
+         * @param x Where the origin goes.
+         * @param y
+         */
+        void draw(u8g2_t *u8g2, int x, int y);
+};
+
+#endif
@@ -0,0 +1,213 @@
+#include "chiko_fill.h"
+#include <string.h>
+
+/*
+    Or and xor masks of the draw color, as u8g2_ll_hvline_vertical_top_lsb()
+    applies them: 0 clears, 1 sets and 2 inverts the pixels of the mask
+    */
+static inline void colorMasks(u8g2_t *u8g2, uint8_t mask, uint8_t *orMask, uint8_t *xorMask) {
+  *orMask = u8g2->draw_color <= 1 ? mask : 0;
+  *xorMask = u8g2->draw_color != 1 ? mask : 0;
+}
+
+/*
+    Pixels of page row page between the rows top and bottom (included)
+    */
+static inline uint8_t pageMask(int page, int top, int bottom) {
+  int first = page * 8;
+  int last = first + 7;
+  if (top > last || bottom < first) {
+    return 0;
+  }
+  uint8_t mask = 0xFF;
+  if (top > first) {
+    mask &= 0xFF << (top - first);
+  }
+  if (bottom < last) {
+    mask &= 0xFF >> (last - bottom);
+  }
+  return mask;
+}
+
+/*
+    Apply the same masks to len consecutive bytes, one 32 bit word at a time
+    */
+static void fillSpan(uint8_t *ptr, unsigned len, uint8_t orMask, uint8_t xorMask) {
+  if (orMask == 0xFF && (xorMask == 0x00 || xorMask == 0xFF)) {
+    // The whole page row is set or cleared
+    memset(ptr, xorMask == 0x00 ? 0xFF : 0x00, len);
+    return;
+  }
+  for (; len > 0 && ((uintptr_t)ptr & 3) != 0; len--, ptr++) {
+    *ptr = (*ptr | orMask) ^ xorMask;
+  }
+  uint32_t orWord = orMask * (uint32_t)0x01010101;
+  uint32_t xorWord = xorMask * (uint32_t)0x01010101;
+  for (; len >= 4; len -= 4, ptr += 4) {
+    uint32_t word;
+    memcpy(&word, ptr, 4);
+    word = (word | orWord) ^ xorWord;
+    memcpy(ptr, &word, 4);
+  }
+  for (; len > 0; len--, ptr++) {
+    *ptr = (*ptr | orMask) ^ xorMask;
+  }
+}
+
+static inline void fillByte(uint8_t *ptr, uint8_t orMask, uint8_t xorMask) {
+  *ptr = (*ptr | orMask) ^ xorMask;
+}
+
+/**
+ * @struct FillCorners
+ * @brief Height of each column of a quarter disc above its center, for every radius.
+ */
+struct FillCorners {
+  uint16_t start[FILL_MAX_RADIUS + 1];                              // First column of each radius
+  uint8_t extent[(FILL_MAX_RADIUS + 1) * (FILL_MAX_RADIUS + 2) / 2];
+};
+
+/*
+    The same midpoint circle as u8g2_DrawDisc(), run by the compiler
+    */
+static constexpr FillCorners makeCorners() {
+  FillCorners corners = {};
+  int start = 0;
+  for (int r = 0; r <= FILL_MAX_RADIUS; r++) {
+    corners.start[r] = start;
+    uint8_t *extent = &corners.extent[start];
+    int f = 1 - r;
+    int ddF_x = 1;
+    int ddF_y = -2 * r;
+    int dx = 0;
+    int dy = r;
+    extent[0] = r;
+    while (dx < dy) {
+      if (f >= 0) {
+        dy--;
+        ddF_y += 2;
+        f += ddF_y;
+      }
+      dx++;
+      ddF_x += 2;
+      f += ddF_x;
+      if (extent[dx] < dy) extent[dx] = dy;
+      if (extent[dy] < dx) extent[dy] = dx;
+    }
+    start += r + 1;
+  }
+  return corners;
+}
+
+static constexpr FillCorners fillCorners = makeCorners();
+
+bool fill_isVerticalTopLsb(u8g2_t *u8g2) {
+  return (u8g2->ll_hvline == u8g2_ll_hvline_vertical_top_lsb || u8g2->ll_hvline == fill_hvline)
+         && u8g2->tile_buf_height == u8g2_GetU8x8(u8g2)->display_info->tile_height
+         && u8g2->cb == &u8g2_cb_r0;
+}
+
+void fill_hvline(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t len, uint8_t dir) {
+  uint16_t width = u8g2->pixel_buf_width;
+  uint8_t *ptr = u8g2->tile_buf_ptr + (y >> 3) * width + x;
+  uint8_t orMask, xorMask;
+  if (dir == 0) {
+    colorMasks(u8g2, 1 << (y & 7), &orMask, &xorMask);
+    fillSpan(ptr, len, orMask, xorMask);
+    return;
+  }
+  int bottom = y + len - 1;
+  for (int page = y >> 3; page <= bottom >> 3; page++, ptr += width) {
+    colorMasks(u8g2, pageMask(page, y, bottom), &orMask, &xorMask);
+    fillByte(ptr, orMask, xorMask);
+  }
+}
+
+void fill_install(u8g2_t *u8g2) {
+  if (u8g2->ll_hvline == u8g2_ll_hvline_vertical_top_lsb) {
+    u8g2->ll_hvline = fill_hvline;
+  }
+}
+
+/*
+    Clip a box against the user window of U8g2 (the buffer and the clip window)
+    */
+static bool clipBox(u8g2_t *u8g2, int x, int y, int w, int h, int *x0, int *y0, int *x1, int *y1) {
+#ifdef U8G2_WITH_CLIP_WINDOW_SUPPORT
+  if (u8g2->is_page_clip_window_intersection == 0) {
+    return false;
+  }
+#endif
+  *x0 = x > u8g2->user_x0 ? x : u8g2->user_x0;
+  *y0 = y > u8g2->user_y0 ? y : u8g2->user_y0;
+  *x1 = x + w < u8g2->user_x1 ? x + w : u8g2->user_x1;
+  *y1 = y + h < u8g2->user_y1 ? y + h : u8g2->user_y1;
+  return *x0 < *x1 && *y0 < *y1;
+}
+
+void fill_box(u8g2_t *u8g2, int x, int y, int w, int h) {
+  if (!fill_isVerticalTopLsb(u8g2)) {
+    u8g2_DrawBox(u8g2, x, y, w, h);
+    return;
+  }
+  int x0, y0, x1, y1;
+  if (!clipBox(u8g2, x, y, w, h, &x0, &y0, &x1, &y1)) {
+    return;
+  }
+  uint16_t width = u8g2->pixel_buf_width;
+  uint8_t orMask, xorMask;
+  for (int page = y0 >> 3; page <= (y1 - 1) >> 3; page++) {
+    colorMasks(u8g2, pageMask(page, y0, y1 - 1), &orMask, &xorMask);
+    fillSpan(u8g2->tile_buf_ptr + page * width + x0, x1 - x0, orMask, xorMask);
+  }
+}
+
+void fill_roundBox(u8g2_t *u8g2, int x, int y, int w, int h, int r) {
+  // Inverting would show where U8g2 draws its discs and boxes over each other
+  if (!fill_isVerticalTopLsb(u8g2) || u8g2->draw_color > 1
+      || r < 0 || r > FILL_MAX_RADIUS || w < 2 * r + 2 || h < 2 * r + 2) {
+    u8g2_DrawRBox(u8g2, x, y, w, h, r);
+    return;
+  }
+  int x0, y0, x1, y1;
+  if (!clipBox(u8g2, x, y, w, h, &x0, &y0, &x1, &y1)) {
+    return;
+  }
+
+  const uint8_t *extent = &fillCorners.extent[fillCorners.start[r]];
+
+  // Centers of the corner discs. Columns between the centers span the whole height,
+  // a column of a corner spans from its upper to its lower disc.
+  int left = x + r;
+  int right = x + w - r - 1;
+  int upper = y + r;
+  int lower = y + h - r - 1;
+  int middle0 = left + 1 > x0 ? left + 1 : x0;
+  int middle1 = right < x1 ? right : x1;
+  int left1 = left + 1 < x1 ? left + 1 : x1;
+  int right0 = right > x0 ? right : x0;
+
+  uint16_t width = u8g2->pixel_buf_width;
+  uint8_t orMask, xorMask;
+  for (int page = y0 >> 3; page <= (y1 - 1) >> 3; page++) {
+    uint8_t *row = u8g2->tile_buf_ptr + page * width;
+    if (middle0 < middle1) {
+      colorMasks(u8g2, pageMask(page, y0, y1 - 1), &orMask, &xorMask);
+      fillSpan(row + middle0, middle1 - middle0, orMask, xorMask);
+    }
+    for (int column = x0; column < left1; column++) {
+      int e = extent[left - column];
+      int top = upper - e > y0 ? upper - e : y0;
+      int bottom = lower + e < y1 - 1 ? lower + e : y1 - 1;
+      colorMasks(u8g2, pageMask(page, top, bottom), &orMask, &xorMask);
+      fillByte(row + column, orMask, xorMask);
+    }
+    for (int column = right0; column < x1; column++) {
+      int e = extent[column - right];
+      int top = upper - e > y0 ? upper - e : y0;
+      int bottom = lower + e < y1 - 1 ? lower + e : y1 - 1;
+      colorMasks(u8g2, pageMask(page, top, bottom), &orMask, &xorMask);
+      fillByte(row + column, orMask, xorMask);
+    }
+  }
+}
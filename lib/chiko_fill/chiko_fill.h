@@ -0,0 +1,53 @@
+#ifndef __CHIKO_FILL__
+#define __CHIKO_FILL__
+
+#include <clib/u8g2.h>
+
+/*
+    Fill kernels for the SSD13xx frame buffer
+    In the vertical top lsb layout of the SSD13xx a buffer byte holds 8 pixels
+    of one column, and the columns of a page row (8 pixel rows) follow each
+    other. U8g2 fills a box one horizontal line at a time, and each line sets
+    one bit in each of its bytes. The kernels below fill a page row of a span
+    at once: one mask for all of its bytes, applied 32 bits at a time, and
+    plain memset() for page rows the span covers completely.
+    Anything these kernels do not support (other buffer layouts, rotations,
+    page buffers) is passed on to U8g2, so they can be called unconditionally.
+*/
+#define FILL_MAX_RADIUS   64   // Largest corner radius of fill_roundBox(), larger ones are drawn by U8g2
+
+/**
+ * @brief Check if u8g2 draws into a full frame buffer with the vertical top lsb layout at
+ *        rotation R0, the layout the kernels and the glyph cache write to.
+ */
+bool fill_isVerticalTopLsb(u8g2_t *u8g2);
+
+/**
+ * @brief Low level line of U8g2, a drop-in replacement of u8g2_ll_hvline_vertical_top_lsb().
+ * @param x Left of the line, within the buffer.
+ * @param y Top of the line, within the buffer.
+ * @param len Length of the line in pixels, not 0.
+ * @param dir 0 for a horizontal line, 1 for a vertical line.
+ */
+void fill_hvline(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t len, uint8_t dir);
+
+/**
+ * @brief Make U8g2 draw its lines with fill_hvline(), if the display has the vertical
+ *        top lsb layout. Every U8g2 drawing function then benefits.
+ */
+void fill_install(u8g2_t *u8g2);
+
+/**
+ * @brief Same as u8g2_DrawBox(), with the current draw color.
+ */
+void fill_box(u8g2_t *u8g2, int x, int y, int w, int h);
+
+/**
+ * @brief Same as u8g2_DrawRBox(), with the current draw color. Each column of a rounded box
+ *        is a single span, so the box is drawn page row by page row instead of as four
+ *        discs and three boxes. The corner profiles are computed at compile time.
+ * @param r Corner radius, the fast path needs w and h of at least 2 * r + 2.
+ */
+void fill_roundBox(u8g2_t *u8g2, int x, int y, int w, int h, int r);
+
+#endif
@@ -1,5 +1,4 @@
 #include "chiko_joint.h"
-#include "config.h"
 #include "chiko_keyboard.h"
 
 
@@ -7,6 +6,16 @@ SelectedJoint SJ = NONE_SELECTED;
 Joint *LFJ, *LLJ, *RFJ, *RLJ;
 Preferences jointOffsets;
 
+// Joint arrival events, bit n is set while the n-th registered joint rests at its setpoint
+static EventGroupHandle_t jointEvents = NULL;
+// Sequence lock of the published setpoints, see the setpoint handoff below
+static std::atomic<uint32_t> jointPoseSequence(0);
+// Pose sequence of the snapshot the tick that last set the arrival bits worked from.
+// A tick may set its bits just after a commit cleared them, waiters that find the
+// bits set by a tick older than their commit wait for the next one.
+static std::atomic<uint32_t> jointReadySequence(0);
+static EventBits_t allJointsBits = 0, leftJointsBits = 0, rightJointsBits = 0;
+
 
 void loadJointsOffsets(void) {
   jointOffsets.begin("offsets", true);  //opening the Joint offset seetings as readonly mode
@@ -144,6 +153,8 @@ void initialize_joints(Joint *LeftFootJoint, Joint *LeftLegJoint, Joint *RightFo
   RFJ->init_joint(RIGHTFOOT_PIN, 100, RF_OFFSET);
   RLJ->init_joint(RIGHTLEG_PIN, 100, RL_OFFSET);
   loadJointsOffsets();
+  leftJointsBits = getJointBit(LLJ) | getJointBit(LFJ);
+  rightJointsBits = getJointBit(RLJ) | getJointBit(RFJ);
   enable_joints();
   // Setting the joints to zero
   RLJ->setToZero();
@@ -153,26 +164,87 @@ void initialize_joints(Joint *LeftFootJoint, Joint *LeftLegJoint, Joint *RightFo
 
 }
 
+/*
+    Check the arrival bits against the poses published up to the given sequence,
+    bits set by a tick whose snapshot is older do not count
+    */
+static bool jointsReady(EventBits_t jointBits, uint32_t sequence) {
+  // The tick clears, then stores its sequence, then sets: once the sequence is
+  // seen, the bits read next already went through that tick's clear
+  uint32_t readySequence = jointReadySequence.load(std::memory_order_acquire);
+  if ((int32_t)(readySequence - sequence) < 0) {
+    return false;
+  }
+  return (xEventGroupGetBits(jointEvents) & jointBits) == jointBits;
+}
+
+bool waitTillJointsAvailable(EventBits_t jointBits, TickType_t timeout) {
+  if (jointEvents == NULL) {
+    return true;
+  }
+  uint32_t sequence = jointPoseSequence.load(std::memory_order_acquire);
+  TickType_t start = xTaskGetTickCount();
+  TickType_t remaining = timeout;
+  while (true) {
+    EventBits_t bits = xEventGroupWaitBits(jointEvents, jointBits, pdFALSE, pdTRUE, remaining);
+    if ((bits & jointBits) != jointBits) {
+      return false;
+    }
+    if (jointsReady(jointBits, sequence)) {
+      return true;
+    }
+    // Set by a tick that had not seen the latest pose, the next tick clears them
+    vTaskDelay(1);
+    if (timeout != portMAX_DELAY) {
+      TickType_t elapsed = xTaskGetTickCount() - start;
+      if (elapsed >= timeout) {
+        return false;
+      }
+      remaining = timeout - elapsed;
+    }
+  }
+}
+
 void waitTillAllJointsAvailable(void){
-  while (allJointsStatus()) {
-    delay(JOINT_UPDATE_RATE);
+  waitTillJointsAvailable(allJointsBits);
+}
+
+void waitTillLeftJointsAvailable(void){
+  waitTillJointsAvailable(leftJointsBits);
+}
+
+void waitTillRightJointsAvailable(void){
+  waitTillJointsAvailable(rightJointsBits);
+}
+
+EventBits_t getJointBit(Joint *joint) {
+  if (joint == NULL || joint->JointIndex < 0) {
+    return 0;
+  }
+  return (EventBits_t)1 << joint->JointIndex;
+}
+
+static bool jointsBusy(EventBits_t jointBits) {
+  if (jointEvents == NULL) {
+    return false;
   }
+  return !jointsReady(jointBits, jointPoseSequence.load(std::memory_order_acquire));
 }
 
 bool getJointStatus(Joint *joint) {
-  return joint->isJointBusy;
+  return jointsBusy(getJointBit(joint));
 }
 
 bool allJointsStatus(void) {
-  return (getJointStatus(LLJ) | getJointStatus(LFJ) | getJointStatus(RLJ) | getJointStatus(RFJ));
+  return jointsBusy(allJointsBits);
 }
 
 bool leftJointsStatus(void) {
-  return (getJointStatus(LLJ) | getJointStatus(LFJ));
+  return jointsBusy(leftJointsBits);
 }
 
 bool rightJointsStatus(void) {
-  return (getJointStatus(RLJ) | getJointStatus(RFJ));
+  return jointsBusy(rightJointsBits);
 }
 
 void enable_joints(void) {
@@ -200,35 +272,288 @@ void setAllJointsBaseSpeed(float BaseSpeed){
 
 
 
-void static processJointMovement(void *param) {
-  while (1) {
-    Joint *obj;
-    obj = (Joint *)param;
-    float JA = obj->JointAngle;
-    float JASP = obj->JointAngleSetPoint;
-    float JASPEED = obj->JointSpeed;
-
-    if (JA != JASP) {
-      obj->isJointBusy = true;
-    } else {
-      obj->isJointBusy = false;
+// ---- Joint scheduler --------------------------------------------------------
+// One task owns every registered joint. A hardware timer wakes it once per
+// update period, it computes the new angle of every joint first and then writes
+// all servos back-to-back so every leg moves in the same PWM frame.
+
+static Joint *registeredJoints[JOINT_MAX_COUNT];
+static uint8_t registeredJointCount = 0;
+static uint32_t jointUpdateRate = JOINT_UPDATE_RATE;
+static hw_timer_t *jointSchedulerTimer = NULL;
+static TaskHandle_t jointSchedulerTaskHandle = NULL;
+static bool jointSchedulerStopped = false;
+// The function and its parameter are swapped together, a tick never sees one without the other
+static std::atomic<const JointTickHook *> jointTickHook(NULL);
+static std::atomic<const JointLatencyCallback *> jointLatencyCallback(NULL);
+
+// ---- Setpoint handoff -------------------------------------------------------
+// The published setpoints of all joints are guarded by a single sequence lock.
+// Writers make the sequence odd while they publish and even again when they are
+// done, the scheduler retries its snapshot if the sequence was odd or changed
+// under it. This way a whole-body pose is seen completely or not at all and no
+// mutex is taken on either side.
+
+static void beginSetPointWrite(void) {
+  // Keep this task from being preempted on its core while the sequence is odd,
+  // otherwise a higher priority writer would spin forever.
+  vTaskSuspendAll();
+  uint32_t seq = jointPoseSequence.load(std::memory_order_relaxed);
+  while ((seq & 1) || !jointPoseSequence.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire)) {
+    seq = jointPoseSequence.load(std::memory_order_relaxed);
+  }
+  std::atomic_thread_fence(std::memory_order_release);
+}
+
+static void endSetPointWrite(void) {
+  jointPoseSequence.fetch_add(1, std::memory_order_release);
+  xTaskResumeAll();
+}
+
+/*
+    Command numbers only grow, a new command always supersedes the queued one
+    */
+static uint32_t nextJointCommand(const JointSetPoint &setPoint, const JointSetPoint &queued) {
+  return max(setPoint.command, queued.command) + 1;
+}
+
+/*
+    Speed of a target in degrees/second, never slower than JOINT_MIN_SPEED
+    */
+static float getTargetSpeed(const JointTarget &target) {
+  return max(((float)target.percentageSpeed) * target.joint->getBaseSpeed() / 100, (float)JOINT_MIN_SPEED);
+}
+
+static EventBits_t getJointQueueBit(Joint *joint) {
+  return getJointBit(joint) << JOINT_MAX_COUNT;
+}
+
+void publishPose(const JointTarget *targets, size_t count, uint32_t durationMs, bool queue, uint32_t inputUs) {
+  EventBits_t jointBits = 0;
+  beginSetPointWrite();
+  for (size_t i = 0; i < count; i++) {
+    Joint *joint = targets[i].joint;
+    JointSetPoint &setPoint = queue ? joint->QueuedSetPoint : joint->PublishedSetPoint;
+    uint32_t command = nextJointCommand(joint->PublishedSetPoint, joint->QueuedSetPoint);
+    setPoint.angle = targets[i].angle;
+    setPoint.speed = getTargetSpeed(targets[i]);
+    setPoint.acceleration = joint->JointAcceleration;
+    setPoint.profile = joint->JointProfile;
+    setPoint.durationMs = durationMs;
+    setPoint.command = command;
+    setPoint.inputUs = inputUs;
+    jointBits |= queue ? getJointQueueBit(joint) : getJointBit(joint);
+  }
+  // Cleared while the sequence is odd, a tick that snapshotted the old setpoints
+  // finds the sequence changed and does not set them again
+  if (jointEvents != NULL) {
+    xEventGroupClearBits(jointEvents, jointBits);
+  }
+  endSetPointWrite();
+}
+
+void commitPose(const JointTarget *targets, size_t count) {
+  publishPose(targets, count, 0, false, 0);
+}
+
+void commitPose(std::initializer_list<JointTarget> targets) {
+  commitPose(targets.begin(), targets.size());
+}
+
+void commitTimedPose(const JointTarget *targets, size_t count, uint32_t durationMs) {
+  if (durationMs == 0) {
+    // The slowest joint decides, every other joint is slowed down to arrive with it
+    float duration = 0;
+    for (size_t i = 0; i < count; i++) {
+      Joint *joint = targets[i].joint;
+      float speed = getTargetSpeed(targets[i]);
+      duration = max(duration, JointTrajectory::minimumDuration(targets[i].angle - joint->JointAngle, speed,
+                                                                joint->JointAcceleration, joint->JointProfile));
     }
+    durationMs = (uint32_t)ceilf(duration * 1000);
+  }
+  if (durationMs == 0) {
+    durationMs = 1; // Already there, still publish so every joint arrives in the next tick
+  }
+  publishPose(targets, count, durationMs, false, 0);
+}
 
-    if (JASP > JA) {
-      JA = JA + JASPEED * JOINT_UPDATE_RATE / (float)1000;
-      if (JA > JASP) {
-        JA = JASP;
-      }
-    } else {
-      JA = JA - JASPEED * JOINT_UPDATE_RATE / (float)1000;
-      if (JA < JASP) {
-        JA = JASP;
+void commitTimedPose(std::initializer_list<JointTarget> targets, uint32_t durationMs) {
+  commitTimedPose(targets.begin(), targets.size(), durationMs);
+}
+
+void queuePose(const JointTarget *targets, size_t count, uint32_t durationMs) {
+  EventBits_t queueBits = 0;
+  for (size_t i = 0; i < count; i++) {
+    queueBits |= getJointQueueBit(targets[i].joint);
+  }
+  // The queue is one move deep, wait until the scheduler started the previously queued move
+  waitTillJointsAvailable(queueBits);
+  publishPose(targets, count, max(durationMs, (uint32_t)1), true, 0);
+}
+
+void queuePose(std::initializer_list<JointTarget> targets, uint32_t durationMs) {
+  queuePose(targets.begin(), targets.size(), durationMs);
+}
+
+void commitInputPose(const JointTarget *targets, size_t count, uint32_t inputUs) {
+  // A move of 1 mS ends within the tick that starts it
+  publishPose(targets, count, 1, false, inputUs);
+}
+
+void commitJointSpeed(Joint *joint, float speed) {
+  beginSetPointWrite();
+  joint->PublishedSetPoint.speed = max(speed, (float)JOINT_MIN_SPEED);
+  joint->PublishedSetPoint.inputUs = 0;
+  joint->PublishedSetPoint.command = nextJointCommand(joint->PublishedSetPoint, joint->QueuedSetPoint);
+  endSetPointWrite();
+}
+
+static void IRAM_ATTR onJointSchedulerTimer(void) {
+  BaseType_t higherPriorityTaskWoken = pdFALSE;
+  vTaskNotifyGiveFromISR(jointSchedulerTaskHandle, &higherPriorityTaskWoken);
+  if (higherPriorityTaskWoken) {
+    portYIELD_FROM_ISR();
+  }
+}
+
+static void jointSchedulerTask(void *param) {
+  while (1) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    jointSchedulerTick();
+  }
+}
+
+void jointSchedulerTick(void) {
+  float angles[JOINT_MAX_COUNT];
+  JointSetPoint setPoints[JOINT_MAX_COUNT];
+  JointSetPoint queuedSetPoints[JOINT_MAX_COUNT];
+  uint32_t inputUs[JOINT_MAX_COUNT];
+  float dt = jointUpdateRate / (float)1000;
+  uint32_t seqBegin, seqEnd;
+
+  const JointTickHook *tickHook = jointTickHook.load(std::memory_order_acquire);
+  if (tickHook != NULL && tickHook->hook != NULL) {
+    tickHook->hook(tickHook->param);
+  }
+
+  // Snapshot the published setpoints of all joints in one consistent read
+  do {
+    seqBegin = jointPoseSequence.load(std::memory_order_acquire);
+    for (uint8_t i = 0; i < registeredJointCount; i++) {
+      setPoints[i] = registeredJoints[i]->PublishedSetPoint;
+      queuedSetPoints[i] = registeredJoints[i]->QueuedSetPoint;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    seqEnd = jointPoseSequence.load(std::memory_order_relaxed);
+  } while ((seqBegin & 1) || seqBegin != seqEnd);
+
+  EventBits_t arrivedBits = 0;
+  EventBits_t queueFreeBits = 0;
+  for (uint8_t i = 0; i < registeredJointCount; i++) {
+    Joint *joint = registeredJoints[i];
+    uint32_t servedCommand = joint->ServedCommand;
+    angles[i] = joint->update(dt, setPoints[i], queuedSetPoints[i]);
+    // Input of the published setpoint, if this tick started it
+    bool started = joint->ServedCommand != servedCommand && joint->ServedCommand == setPoints[i].command;
+    inputUs[i] = started ? setPoints[i].inputUs : 0;
+    bool queueFree = queuedSetPoints[i].command <= joint->ServedCommand;
+    if (queueFree) {
+      queueFreeBits |= getJointQueueBit(joint);
+    }
+    if (queueFree && angles[i] == joint->JointAngleSetPoint) {
+      arrivedBits |= getJointBit(joint);
+    }
+  }
+  for (uint8_t i = 0; i < registeredJointCount; i++) {
+    registeredJoints[i]->ServoWrite(angles[i]);
+  }
+  const JointLatencyCallback *latencyCallback = jointLatencyCallback.load(std::memory_order_acquire);
+  if (latencyCallback != NULL && latencyCallback->callback != NULL) {
+    // The oldest input written in this tick, a pose is reported once
+    uint32_t writtenUs = micros();
+    uint32_t latencyUs = 0;
+    bool started = false;
+    for (uint8_t i = 0; i < registeredJointCount; i++) {
+      if (inputUs[i] != 0) {
+        latencyUs = max(latencyUs, writtenUs - inputUs[i]);
+        started = true;
       }
     }
-    // Serial.printf("SP: %.2f,\t CA: %.2f,\t S: %.2f\n",JASP,JA,JASPEED);
-    obj->ServoWrite(JA);
-    delay(JOINT_UPDATE_RATE);
+    if (started) {
+      latencyCallback->callback(latencyCallback->param, latencyUs);
+    }
+  }
+
+  // Signal arrivals in the same tick the joints reach their setpoints
+  EventBits_t allBits = allJointsBits | (allJointsBits << JOINT_MAX_COUNT);
+  EventBits_t readyBits = arrivedBits | queueFreeBits;
+  xEventGroupClearBits(jointEvents, allBits & ~readyBits);
+  // A writer may have published a new setpoint after the snapshot, its joints
+  // stay busy until the next tick has seen it. One that publishes between this
+  // check and the set is caught by the waiters through jointReadySequence.
+  if (jointPoseSequence.load(std::memory_order_acquire) == seqBegin) {
+    jointReadySequence.store(seqBegin, std::memory_order_release);
+    xEventGroupSetBits(jointEvents, readyBits);
+  }
+}
+
+void startJointScheduler(uint32_t updateRate) {
+  if (jointSchedulerTaskHandle != NULL) {
+    if (jointSchedulerStopped) {
+      jointSchedulerStopped = false;
+      setJointUpdateRate(updateRate);
+      timerStart(jointSchedulerTimer);
+    }
+    return;
+  }
+  jointUpdateRate = updateRate;
+  xTaskCreate(jointSchedulerTask, "Joint Scheduler", JOINT_SCHEDULER_STACK_SIZE, NULL, JOINT_SCHEDULER_PRIORITY, &jointSchedulerTaskHandle);
+
+  jointSchedulerTimer = timerBegin(JOINT_SCHEDULER_TIMER_FREQ);
+  timerAttachInterrupt(jointSchedulerTimer, &onJointSchedulerTimer);
+  timerAlarm(jointSchedulerTimer, jointUpdateRate * (JOINT_SCHEDULER_TIMER_FREQ / 1000), true, 0);
+}
+
+void stopJointScheduler(void) {
+  if (jointSchedulerTimer != NULL) {
+    jointSchedulerStopped = true;
+    timerStop(jointSchedulerTimer);
+  }
+}
+
+void setJointUpdateRate(uint32_t updateRate) {
+  jointUpdateRate = updateRate;
+  if (jointSchedulerTimer != NULL) {
+    timerAlarm(jointSchedulerTimer, jointUpdateRate * (JOINT_SCHEDULER_TIMER_FREQ / 1000), true, 0);
+  }
+}
+
+uint32_t getJointUpdateRate(void) {
+  return jointUpdateRate;
+}
+
+void setJointTickHook(const JointTickHook *hook) {
+  jointTickHook.store(hook, std::memory_order_release);
+}
+
+void setJointLatencyCallback(const JointLatencyCallback *callback) {
+  jointLatencyCallback.store(callback, std::memory_order_release);
+}
+
+bool registerJoint(Joint *joint) {
+  if (registeredJointCount >= JOINT_MAX_COUNT) {
+    return false;
   }
+  if (jointEvents == NULL) {
+    jointEvents = xEventGroupCreate();
+  }
+  joint->JointIndex = registeredJointCount;
+  registeredJoints[registeredJointCount++] = joint;
+  allJointsBits |= getJointBit(joint);
+  xEventGroupSetBits(jointEvents, getJointBit(joint) | getJointQueueBit(joint));
+  startJointScheduler(jointUpdateRate);
+  return true;
 }
 
 
@@ -244,16 +569,53 @@ void JointSweepTask(void *param) {
 }
 
 
+/*
+    Plan the move to a new setpoint starting from the current angle and speed
+    */
+void Joint::planMove(const JointSetPoint &setPoint, float startAngle, float startSpeed) {
+  JointAngleSetPoint = setPoint.angle;
+  JointSpeed = setPoint.speed;
+  ServedCommand = setPoint.command;
+  if (setPoint.durationMs > 0) {
+    Trajectory.planDuration(startAngle, setPoint.angle, setPoint.durationMs / (float)1000, setPoint.profile,
+                            startSpeed);
+  } else {
+    Trajectory.planLimits(startAngle, setPoint.angle, setPoint.speed, setPoint.acceleration, setPoint.profile,
+                          startSpeed);
+  }
+  TrajectoryTime = 0;
+}
+
+/*
+    Advance the joint along its trajectory by one scheduler period
+    */
+float Joint::update(float dt, const JointSetPoint &setPoint, const JointSetPoint &queued) {
+  if (setPoint.command > ServedCommand) {
+    // A joint retargeted mid-move carries its speed into the new move
+    planMove(setPoint, JointAngle, Trajectory.getSpeed(TrajectoryTime));
+  }
+  TrajectoryTime += dt;
+  // Chain the queued move at the exact end of the current one, without a gap
+  if (TrajectoryTime >= Trajectory.getDuration() && queued.command > ServedCommand) {
+    // An idle joint keeps counting, never start the queued move more than one period late
+    float overshoot = min(TrajectoryTime - Trajectory.getDuration(), dt);
+    planMove(queued, Trajectory.getTarget(), 0);
+    TrajectoryTime = overshoot;
+  }
+  return Trajectory.evaluate(TrajectoryTime);
+}
+
 void Joint::ServoWrite(float angle) {
   JointAngle = angle;
-  JointServo.write(JointAngle + 90 + JointOffset);  // Servo Mid point
+  JointServo.write(JointAngle + getTrim() + 90 + JointOffset);  // Servo Mid point
 }
 /*
     Set the Joint to zero position
     */
 void Joint::setToZero(void) {
-  JointAngle = 0;
-  ServoWrite(JointAngle);
+  // The scheduler writes the servo, a 1 mS move ends in the tick that starts it
+  JointTarget target = {this, 0, 100};
+  commitTimedPose(&target, 1, 1);
 }
 
 /*
@@ -263,30 +625,35 @@ void Joint::init_joint(int JointPort, float speed, float offset) {
   JointServo.setFrequency(50);            // standard 50 hz servo
   JointServo.setResolution(10);           // 10 bit resolution
   JointServo.attach(JointPort, 0); // attaches the servo on pin to the servo object
-  ServoWrite(JointAngle);
+  ServoWrite(JointAngle);  // Not registered yet, the scheduler takes over the writes from here
   JointSpeed = speed;
+  PublishedSetPoint.angle = JointAngle;
+  PublishedSetPoint.speed = speed;
   JointOffset = offset;
-  xTaskCreate(processJointMovement, "Joint Movement Task", 5000, this, JOINT_TASK_PRIORITY, NULL);
+  registerJoint(this);
 }
 
 /*
         Make a fastest moment of the joint by making a step change in the joint angle
     */
 void Joint::stepAngle(DIRECTION direction) {
+  float angle;
   if (direction == POSITIVE) {  // Positive Direction
     if (JointAngle + STEP_ANGLE > 90) {
-      JointAngle = 90;
+      angle = 90;
     } else {
-      JointAngle = JointAngle + STEP_ANGLE;
+      angle = JointAngle + STEP_ANGLE;
     }
   } else {  // Negative Direction
     if (JointAngle - STEP_ANGLE < -90) {
-      JointAngle = -90;
+      angle = -90;
     } else {
-      JointAngle = JointAngle - STEP_ANGLE;
+      angle = JointAngle - STEP_ANGLE;
     }
   }
-  ServoWrite(JointAngle);
+  // Published like any other move, the scheduler reaches it in the next tick
+  JointTarget target = {this, angle, 100};
+  commitTimedPose(&target, 1, 1);
 }
 
 /*
@@ -323,18 +690,44 @@ void Joint::startJointSweep(bool bindKey) {
     */
 void Joint::setAngle(float angle, int percentageSpeed, bool enable) {
   if (enable) {
-    JointAngleSetPoint = angle;
-    JointSpeed = ((float)percentageSpeed) * getBaseSpeed() / 100;
-    isJointBusy = true ;
+    JointTarget target = {this, angle, percentageSpeed};
+    commitPose(&target, 1);
   }
 }
 
 
+/*
+    Move joint to the given angle in a fixed time
+    */
+void Joint::moveTo(float angle, uint32_t durationMs) {
+  JointTarget target = {this, angle, 100};
+  commitTimedPose(&target, 1, durationMs);
+}
+
+void Joint::setProfile(TRAJECTORY_PROFILE profile) {
+  JointProfile = profile;
+}
+
+void Joint::setAcceleration(float acceleration) {
+  JointAcceleration = acceleration;
+}
+
+/*
+    The trim is picked up by the next servo write of the scheduler
+    */
+void Joint::setTrim(float trim) {
+  JointTrim.store(trim, std::memory_order_relaxed);
+}
+
+float Joint::getTrim(void) {
+  return JointTrim.load(std::memory_order_relaxed);
+}
+
 /*
     Set joint speed
     */
 void Joint::setSpeed(float speed) {
-  JointSpeed = speed;
+  commitJointSpeed(this, speed);
 }
 
 float Joint::getSpeed(void){
@@ -4,7 +4,11 @@
 #include <Arduino.h>
 #include <ESP32Servo.h>
 #include <RTOS.h>
+#include <freertos/event_groups.h>
 #include <Preferences.h>
+#include <atomic>
+#include <initializer_list>
+#include "chiko_trajectory.h"
 
 /*
  Model no: SG90
@@ -26,6 +30,20 @@
 */
 #define JOINT_TASK_PRIORITY    2 
 
+/*
+    Joint Scheduler
+    A single task updates every registered joint in one pass. The task is woken by a
+    hardware timer every JOINT_UPDATE_RATE mS so all servos are written in the same
+    PWM frame. It runs above the action tasks to keep the gait timing deterministic.
+*/
+#define JOINT_SCHEDULER_PRIORITY      4
+#define JOINT_SCHEDULER_STACK_SIZE    3072
+#define JOINT_SCHEDULER_TIMER_FREQ    1000000 // [Hz] 1 MHz timer base, 1 uS resolution
+
+// Maximum number of joints the scheduler can own. Each joint uses two event group bits
+// (arrival and queue free), FreeRTOS event groups offer 24 bits.
+#define JOINT_MAX_COUNT      4
+
 // Deafult speed of joint movement is set to 720°/second
 // Smaller joints are made with MG90 Servos which are quite fast and can acheive these speeds
 // while bigger joints are made of MG996r, which are slow. In the case of bigger joints the joint will
@@ -34,6 +52,18 @@
 // minimum speed.
 #define DEFAULT_JOINT_SPEED 300     
 
+// Slowest speed a joint is moved at [°/second]. A speed of 0 would plan a move of no duration and
+// the joint would jump to its target, lower speeds are raised to this.
+#define JOINT_MIN_SPEED 1
+
+// Default acceleration limit of joint movement [°/second²]. Used by the trapezoidal and
+// S-curve profiles to ramp the speed up and down instead of starting and stopping abruptly,
+// which keeps the current peaks of the servos down.
+#define DEFAULT_JOINT_ACCELERATION 3000
+
+// Default velocity profile of joint movement (see TRAJECTORY_PROFILE)
+#define DEFAULT_JOINT_PROFILE TRAPEZOIDAL
+
 // Update rate of joint setpoint
 #define JOINT_UPDATE_RATE    20 //[mS] 20 mS is 50 Hz
 
@@ -91,6 +121,50 @@ enum SelectedJoint {
 
 
 
+class Joint;
+
+/**
+ * @struct JointSetPoint
+ * @brief Setpoint of a joint as published to the joint scheduler.
+ */
+struct JointSetPoint {
+    float angle = 0;                    // Target angle in degrees
+    float speed = DEFAULT_JOINT_SPEED;  // Maximum speed in degrees/second
+    float acceleration = DEFAULT_JOINT_ACCELERATION; // Maximum acceleration in degrees/second^2
+    uint32_t durationMs = 0;            // Duration of the move in mS, 0 to move as fast as the limits allow
+    TRAJECTORY_PROFILE profile = DEFAULT_JOINT_PROFILE; // Velocity profile of the move
+    uint32_t command = 0;               // Incremented on every publish so the scheduler can tell a new move
+    uint32_t inputUs = 0;               // micros() when the input the setpoint follows arrived, 0 if it follows none
+};
+
+/**
+ * @struct JointTickHook
+ * @brief Function the scheduler runs at the start of every tick, see setJointTickHook().
+ */
+struct JointTickHook {
+    void (*hook)(void *param);  // Runs in the scheduler task, must not block
+    void *param;                // Passed to the function
+};
+
+/**
+ * @struct JointLatencyCallback
+ * @brief Function the scheduler calls with the latency of an input, see setJointLatencyCallback().
+ */
+struct JointLatencyCallback {
+    void (*callback)(void *param, uint32_t latencyUs); // Runs in the scheduler task, must not block
+    void *param;                                       // Passed to the function
+};
+
+/**
+ * @struct JointTarget
+ * @brief One joint of a whole-body pose committed with commitPose().
+ */
+struct JointTarget {
+    Joint *joint;           // Joint to move
+    float angle;            // Target angle in degrees
+    int percentageSpeed;    // Speed as a percentage of the joint base speed
+};
+
 /**
  * @class Joint
  * @brief Represents a servo-controlled joint for the ChikoBot robot.
@@ -100,23 +174,55 @@ class Joint{
     private:
         ESP32Servo JointServo;  // Servo object to control the joint
         TaskHandle_t JointSweepTaskHandle = NULL; // RTOS task handle for sweeping motion
+        JointSetPoint PublishedSetPoint; // Setpoint published by the action tasks, guarded by the pose sequence lock
+        JointSetPoint QueuedSetPoint;    // Setpoint started as soon as the current move ends, same guard
+        uint32_t ServedCommand = 0;      // Last published command the scheduler has started
+        JointTrajectory Trajectory;      // Move the scheduler is currently following
+        float TrajectoryTime = 0;        // Time since the start of the move [s]
+        std::atomic<float> JointTrim{0}; // Correction added on top of the trajectory, e.g. by the balance controller [deg]
+
+        /**
+         * @brief Plan the move to a new setpoint.
+         * @param setPoint The setpoint to move to.
+         * @param startAngle Angle the move starts from.
+         * @param startSpeed Speed of the joint when the move starts, in degrees/second.
+         */
+        void planMove(const JointSetPoint &setPoint, float startAngle, float startSpeed);
+
+        friend void jointSchedulerTick(void);
+        friend void publishPose(const JointTarget *targets, size_t count, uint32_t durationMs, bool queue, uint32_t inputUs);
+        friend void commitJointSpeed(Joint *joint, float speed);
     public:
         float JointOffset = 0;   // Measured offset of the joint
         float JointAngle = 0;    // Current angle of the joint
-        float JointAngleSetPoint = 0; // Target angle for the joint
-        float JointSpeed = DEFAULT_JOINT_SPEED; // Current speed of the joint
+        float JointAngleSetPoint = 0; // Target angle the scheduler is moving the joint to
+        float JointSpeed = DEFAULT_JOINT_SPEED; // Speed the scheduler is moving the joint at
         float JointBaseSpeed = DEFAULT_JOINT_SPEED; // Base speed for the joint
+        float JointAcceleration = DEFAULT_JOINT_ACCELERATION; // Acceleration limit of the joint
+        TRAJECTORY_PROFILE JointProfile = DEFAULT_JOINT_PROFILE; // Velocity profile of the joint moves
         bool enableSweep = false; // Whether sweep mode is enabled
-        bool isJointBusy = false; // Whether the joint is currently moving
+        int8_t JointIndex = -1; // Index of the joint in the joint scheduler, also its arrival event bit
 
         /**
          * @brief Write a specific angle to the servo (low-level control).
+         *        Called by the joint scheduler only once the joint is registered, move the joint
+         *        with setAngle() or the commit functions instead.
          * @param angle Angle in degrees to set the servo to.
          */
         void ServoWrite(float angle);
 
         /**
-         * @brief Set the joint to its zero (home) position.
+         * @brief Advance the joint along its trajectory by one scheduler period.
+         *        Called by the joint scheduler only, the returned angle is written by the scheduler.
+         * @param dt Time elapsed since the last update in seconds.
+         * @param setPoint Snapshot of the published setpoint.
+         * @param queued Snapshot of the queued setpoint, started when the current move ends.
+         * @return The new joint angle in degrees.
+         */
+        float update(float dt, const JointSetPoint &setPoint, const JointSetPoint &queued);
+
+        /**
+         * @brief Set the joint to its zero (home) position, in the next scheduler tick.
          */
         void setToZero(void);
 
@@ -129,7 +235,7 @@ class Joint{
         void init_joint(int JointPort, float speed = DEFAULT_JOINT_SPEED, float offset=0);
 
         /**
-         * @brief Move the joint by a step in the specified direction.
+         * @brief Move the joint by a step in the specified direction, in the next scheduler tick.
          * @param direction Direction to move (POSITIVE or NEGATIVE).
          */
         void stepAngle (DIRECTION direction);
@@ -159,6 +265,39 @@ class Joint{
          */
         void setAngle(float angle,int percentageSpeed=20, bool enable=true);
 
+        /**
+         * @brief Move the joint to a given angle in a fixed time.
+         * @param angle Target angle in degrees.
+         * @param durationMs Duration of the move in mS.
+         */
+        void moveTo(float angle, uint32_t durationMs);
+
+        /**
+         * @brief Set the velocity profile used for the following moves.
+         * @param profile The profile (see TRAJECTORY_PROFILE).
+         */
+        void setProfile(TRAJECTORY_PROFILE profile);
+
+        /**
+         * @brief Set the acceleration limit used for the following moves.
+         * @param acceleration Acceleration in degrees/second^2.
+         */
+        void setAcceleration(float acceleration);
+
+        /**
+         * @brief Set a correction that is added to the joint angle on every servo write.
+         *        The trim does not change the setpoint or the trajectory, so it can be
+         *        applied underneath any running action.
+         * @param trim Correction in degrees.
+         */
+        void setTrim(float trim);
+
+        /**
+         * @brief Get the correction added to the joint angle.
+         * @return Correction in degrees.
+         */
+        float getTrim(void);
+
         /**
          * @brief Set the speed of the joint.
          * @param speed Speed value to set.
@@ -225,27 +364,34 @@ void jointCalibrationsRoutine(void);
 /**
  * @brief Get the status of a specific joint.
  * @param joint The joint to check.
- * @return True if the joint is enabled/active, false otherwise.
+ * @return True if the joint is busy moving to its setpoint, false otherwise.
  */
-bool getJointStatus(Joint joint);
+bool getJointStatus(Joint *joint);
 
 /**
- * @brief Check if all joints are enabled/active.
- * @return True if all joints are enabled, false otherwise.
+ * @brief Check if any of the joints is busy.
+ * @return True if any joint is moving to its setpoint, false otherwise.
  */
 bool allJointsStatus(void);
 
 /**
- * @brief Check if the left-side joints are enabled/active.
- * @return True if left joints are enabled, false otherwise.
+ * @brief Check if any of the left-side joints is busy.
+ * @return True if a left joint is moving to its setpoint, false otherwise.
  */
-bool leftJointStatus(void);
+bool leftJointsStatus(void);
 
 /**
- * @brief Check if the right-side joints are enabled/active.
- * @return True if right joints are enabled, false otherwise.
+ * @brief Check if any of the right-side joints is busy.
+ * @return True if a right joint is moving to its setpoint, false otherwise.
  */
-bool rightJointStatus(void);
+bool rightJointsStatus(void);
+
+/**
+ * @brief Get the arrival event bit of a joint.
+ * @param joint The joint.
+ * @return Event bit that is set while the joint rests at its setpoint, 0 if the joint is not registered.
+ */
+EventBits_t getJointBit(Joint *joint);
 
 /**
  * @brief Set the speed for all joints.
@@ -264,5 +410,145 @@ void setAllJointsBaseSpeed(float BaseSpeed);
  */
 void waitTillAllJointsAvailable(void);
 
+/**
+ * @brief Block execution until both left joints are available (not busy).
+ */
+void waitTillLeftJointsAvailable(void);
+
+/**
+ * @brief Block execution until both right joints are available (not busy).
+ */
+void waitTillRightJointsAvailable(void);
+
+/**
+ * @brief Block execution until every joint in jointBits reaches its setpoint.
+ *        The caller unblocks in the same scheduler tick the last joint arrives.
+ * @param jointBits OR-ed arrival bits of the joints, see getJointBit().
+ * @param timeout Maximum time to wait in RTOS ticks (default: forever).
+ * @return True if all joints arrived, false on timeout.
+ */
+bool waitTillJointsAvailable(EventBits_t jointBits, TickType_t timeout = portMAX_DELAY);
+
+/**
+ * @brief Atomically publish the setpoints of several joints (e.g. a whole-body pose).
+ *        The joint scheduler either sees all of them or none, never a half applied pose.
+ * @param targets Array of joint targets.
+ * @param count Number of entries in the array.
+ */
+void commitPose(const JointTarget *targets, size_t count);
+
+/**
+ * @brief Atomically publish the setpoints of several joints (e.g. a whole-body pose).
+ * @param targets List of joint targets, e.g. {{&LeftFoot, 20, 50}, {&RightFoot, 40, 100}}.
+ */
+void commitPose(std::initializer_list<JointTarget> targets);
+
+/**
+ * @brief Atomically publish a pose in which all joints arrive at the same time.
+ * @param targets Array of joint targets.
+ * @param count Number of entries in the array.
+ * @param durationMs Duration of the move in mS. If 0, the slowest joint of the pose
+ *        (given its speed and acceleration limits) sets the duration for all joints.
+ */
+void commitTimedPose(const JointTarget *targets, size_t count, uint32_t durationMs = 0);
+
+/**
+ * @brief Atomically publish a pose in which all joints arrive at the same time.
+ * @param targets List of joint targets.
+ * @param durationMs Duration of the move in mS, 0 to let the slowest joint decide.
+ */
+void commitTimedPose(std::initializer_list<JointTarget> targets, uint32_t durationMs = 0);
+
+/**
+ * @brief Queue a pose to start exactly when the current move of its joints ends.
+ *        The queue is one pose deep: blocks until the scheduler has started the
+ *        previously queued pose, so a caller can always stay one pose ahead.
+ *        A later commitPose() discards the queued pose.
+ * @param targets Array of joint targets.
+ * @param count Number of entries in the array.
+ * @param durationMs Duration of the queued move in mS.
+ */
+void queuePose(const JointTarget *targets, size_t count, uint32_t durationMs);
+
+/**
+ * @brief Queue a pose to start exactly when the current move of its joints ends.
+ * @param targets List of joint targets.
+ * @param durationMs Duration of the queued move in mS.
+ */
+void queuePose(std::initializer_list<JointTarget> targets, uint32_t durationMs);
+
+/**
+ * @brief Atomically publish a pose that follows a live input, e.g. a joystick. The joints
+ *        reach it in the next scheduler tick, rate limits are up to the caller.
+ *        The time of the input goes with the setpoints, see setJointLatencyCallback().
+ * @param targets Array of joint targets, the speed is not used.
+ * @param count Number of entries in the array.
+ * @param inputUs micros() when the input arrived.
+ */
+void commitInputPose(const JointTarget *targets, size_t count, uint32_t inputUs);
+
+/**
+ * @brief Publish a new speed for a joint while keeping its current target angle.
+ * @param joint The joint to update.
+ * @param speed Speed in degrees/second, at least JOINT_MIN_SPEED.
+ */
+void commitJointSpeed(Joint *joint, float speed);
+
+/**
+ * @brief Start the joint scheduler. Called automatically when the first joint is initialized,
+ *        restarts the timer after stopJointScheduler().
+ * @param updateRate Update period of all joints in mS (default: JOINT_UPDATE_RATE).
+ */
+void startJointScheduler(uint32_t updateRate = JOINT_UPDATE_RATE);
+
+/**
+ * @brief Stop the scheduler timer, the joints hold their angle until the scheduler
+ *        is started again or jointSchedulerTick() is called by hand.
+ */
+void stopJointScheduler(void);
+
+/**
+ * @brief Change the update period of the joint scheduler.
+ * @param updateRate Update period of all joints in mS.
+ */
+void setJointUpdateRate(uint32_t updateRate);
+
+/**
+ * @brief Get the update period of the joint scheduler.
+ * @return Update period in mS.
+ */
+uint32_t getJointUpdateRate(void);
+
+/**
+ * @brief Register a joint with the joint scheduler.
+ * @param joint Pointer to the joint to be updated by the scheduler.
+ * @return True if the joint was registered, false if the scheduler is full.
+ */
+bool registerJoint(Joint *joint);
+
+/**
+ * @brief Run a function at the start of every scheduler tick, before the setpoints are read,
+ *        so a pose it commits is written to the servos in the same tick. The function runs in
+ *        the scheduler task and must not block.
+ * @param hook The function and its parameter, NULL to remove it. Swapped in as a whole, it must
+ *        not change while installed and must stay valid, a running tick may still call it
+ *        after it was removed.
+ */
+void setJointTickHook(const JointTickHook *hook);
+
+/**
+ * @brief Call a function after every tick that started a pose committed with commitInputPose(),
+ *        from the scheduler task, right after the servos were written.
+ * @param callback The function and its parameter, NULL to remove it. The function gets the time
+ *        from the input to the servo write in uS. Swapped in as a whole like setJointTickHook().
+ */
+void setJointLatencyCallback(const JointLatencyCallback *callback);
+
+/**
+ * @brief Update all registered joints once and write their servos back-to-back.
+ *        Normally called by the scheduler task on every timer tick.
+ */
+void jointSchedulerTick(void);
+
 
 #endif
@@ -0,0 +1,225 @@
+/**
+ * @file chiko_trajectory.cpp
+ * @brief Time-parameterized joint trajectories (constant speed, trapezoidal, S-curve and minimum-jerk).
+ *
+ * Every profile is described by the distance of the move and a handful of coefficients that are
+ * computed once when the move is planned. The joint scheduler then only evaluates a low order
+ * polynomial per tick. Trapezoidal and S-curve moves ramp from the start speed to a cruise speed and
+ * from the cruise speed to rest, both ramps have the same shape.
+ */
+
+#include "chiko_trajectory.h"
+
+/**
+ * @brief Average acceleration of the speed ramps, the peak acceleration of an S-curve is twice its average.
+ */
+static float getRampAcceleration(TRAJECTORY_PROFILE profile, float maxAcceleration) {
+  return profile == S_CURVE ? maxAcceleration / 2 : maxAcceleration;
+}
+
+float JointTrajectory::minimumDuration(float distance, float maxSpeed, float maxAcceleration, TRAJECTORY_PROFILE profile) {
+  JointTrajectory trajectory;
+  trajectory.planLimits(0, fabsf(distance), maxSpeed, maxAcceleration, profile);
+  return trajectory.getDuration();
+}
+
+/*
+    Speed of a ramp from 0 to 1 at the fraction u of its duration
+    */
+float JointTrajectory::rampShape(float u) {
+  if (Profile == TRAPEZOIDAL) {
+    return u;
+  }
+  // S-curve: jerk up for the first half of the ramp, jerk down for the second half
+  return u < 0.5f ? 2 * u * u : 1 - 2 * (1 - u) * (1 - u);
+}
+
+/*
+    Distance covered by a ramp from 0 to 1 at the fraction u of its duration, per second of ramp
+    */
+float JointTrajectory::rampIntegral(float u) {
+  if (Profile == TRAPEZOIDAL) {
+    return u * u / 2;
+  }
+  float r = 1 - u;
+  return u < 0.5f ? 2 * u * u * u / 3 : u - 0.5f + 2 * r * r * r / 3;
+}
+
+/*
+    Compute the coefficients of the move, Start, Target, Distance and StartSpeed must be set.
+    The speeds follow from the distance and the durations of the phases.
+    */
+void JointTrajectory::planPhases(TRAJECTORY_PROFILE profile, float duration, float rampTime, float stopTime) {
+  Profile = profile;
+  Duration = max(duration, (float)0);
+  RampTime = StopTime = CruiseTime = PeakSpeed = 0;
+  Quintic[0] = Quintic[1] = Quintic[2] = 0;
+  // A move of zero distance still lasts its duration, so joints moved together stay in step
+  if (Duration <= 0 || Profile == CONSTANT_SPEED) {
+    StartSpeed = 0;  // Starts and stops abruptly
+  }
+  if (Duration <= 0) {
+    return;
+  }
+  InvDuration = 1 / Duration;
+
+  switch (Profile) {
+    case TRAPEZOIDAL:
+    case S_CURVE:
+      RampTime = min(rampTime, Duration);
+      StopTime = min(stopTime, Duration - RampTime);
+      CruiseTime = Duration - RampTime - StopTime;
+      PeakSpeed = (Distance - RampTime * StartSpeed / 2) / (Duration - (RampTime + StopTime) / 2);
+      break;
+
+    case MINIMUM_JERK: {
+      // Quintic from the start speed to rest, without acceleration at either end
+      float vt = StartSpeed * Duration;
+      float t3 = Duration * Duration * Duration;
+      Quintic[0] = (10 * Distance - 6 * vt) / t3;
+      Quintic[1] = (-15 * Distance + 8 * vt) / (t3 * Duration);
+      Quintic[2] = (6 * Distance - 3 * vt) / (t3 * Duration * Duration);
+      break;
+    }
+
+    case CONSTANT_SPEED:
+    default:
+      PeakSpeed = Distance * InvDuration;
+      break;
+  }
+}
+
+void JointTrajectory::planDuration(float start, float target, float duration, TRAJECTORY_PROFILE profile, float startSpeed) {
+  Start = start;
+  Target = target;
+  Direction = (target >= start) ? 1 : -1;
+  Distance = fabsf(target - start);
+  StartSpeed = startSpeed * Direction;
+  planPhases(profile, duration, duration * TRAJECTORY_ACCEL_FRACTION, duration * TRAJECTORY_ACCEL_FRACTION);
+}
+
+void JointTrajectory::planLimits(float start, float target, float maxSpeed, float maxAcceleration, TRAJECTORY_PROFILE profile,
+                                 float startSpeed) {
+  Start = start;
+  Target = target;
+  Direction = (target >= start) ? 1 : -1;
+  Distance = fabsf(target - start);
+  StartSpeed = startSpeed * Direction;
+  if (maxSpeed <= 0) {
+    planPhases(profile, 0, 0, 0);
+    return;
+  }
+  if (maxAcceleration <= 0) {
+    profile = CONSTANT_SPEED;
+  }
+
+  switch (profile) {
+    case TRAPEZOIDAL:
+    case S_CURVE: {
+      float accel = getRampAcceleration(profile, maxAcceleration);
+      float stopDistance = StartSpeed * StartSpeed / (2 * accel);
+      float peak;
+      if (StartSpeed > 0 && stopDistance > Distance) {
+        // Too fast to stop at the target: overshoot, come back and stop there
+        peak = -min(sqrtf((stopDistance - Distance) * accel), maxSpeed);
+      } else {
+        // Speed up (or down to the limit), cruise if there is room and stop at the target
+        peak = min(sqrtf((Distance + stopDistance) * accel), maxSpeed);
+      }
+      float rampTime = fabsf(peak - StartSpeed) / accel;
+      float stopTime = fabsf(peak) / accel;
+      float rampDistance = rampTime * (StartSpeed + peak) / 2 + stopTime * peak / 2;
+      float cruiseTime = peak != 0 ? max((Distance - rampDistance) / peak, (float)0) : 0;
+      planPhases(profile, rampTime + cruiseTime + stopTime, rampTime, stopTime);
+      break;
+    }
+
+    case MINIMUM_JERK:
+      // Peak speed is 1.875 D/T and peak acceleration 5.7735 D/T^2 from rest, a
+      // moving joint gets at least the time to stop at that acceleration
+      planPhases(profile, max(max(1.875f * Distance / maxSpeed, sqrtf(5.7735f * Distance / maxAcceleration)),
+                              2 * fabsf(StartSpeed) / maxAcceleration), 0, 0);
+      break;
+
+    case CONSTANT_SPEED:
+    default:
+      planPhases(CONSTANT_SPEED, Distance / maxSpeed, 0, 0);
+      break;
+  }
+}
+
+float JointTrajectory::evaluate(float t) {
+  if (t >= Duration) {
+    return Target;
+  }
+  if (t <= 0) {
+    return Start;
+  }
+
+  float s;
+  switch (Profile) {
+    case TRAPEZOIDAL:
+    case S_CURVE:
+      if (t < RampTime) {
+        s = StartSpeed * t + (PeakSpeed - StartSpeed) * RampTime * rampIntegral(t / RampTime);
+      } else {
+        s = RampTime * (StartSpeed + PeakSpeed) / 2;
+        t -= RampTime;
+        if (t <= CruiseTime) {
+          s += PeakSpeed * t;
+        } else {
+          t -= CruiseTime;
+          s += PeakSpeed * (CruiseTime + t - StopTime * rampIntegral(t / StopTime));
+        }
+      }
+      break;
+
+    case MINIMUM_JERK:
+      s = t * (StartSpeed + t * t * (Quintic[0] + t * (Quintic[1] + t * Quintic[2])));
+      break;
+
+    case CONSTANT_SPEED:
+    default:
+      s = PeakSpeed * t;
+      break;
+  }
+  return Start + Direction * s;
+}
+
+float JointTrajectory::getSpeed(float t) {
+  if (t >= Duration || t < 0) {
+    return 0;
+  }
+
+  float v;
+  switch (Profile) {
+    case TRAPEZOIDAL:
+    case S_CURVE:
+      if (t < RampTime) {
+        v = StartSpeed + (PeakSpeed - StartSpeed) * rampShape(t / RampTime);
+      } else if (t <= RampTime + CruiseTime) {
+        v = PeakSpeed;
+      } else {
+        v = PeakSpeed * (1 - rampShape((t - RampTime - CruiseTime) / StopTime));
+      }
+      break;
+
+    case MINIMUM_JERK:
+      v = StartSpeed + t * t * (3 * Quintic[0] + t * (4 * Quintic[1] + t * 5 * Quintic[2]));
+      break;
+
+    case CONSTANT_SPEED:
+    default:
+      v = PeakSpeed;
+      break;
+  }
+  return Direction * v;
+}
+
+float JointTrajectory::getDuration(void) {
+  return Duration;
+}
+
+float JointTrajectory::getTarget(void) {
+  return Target;
+}
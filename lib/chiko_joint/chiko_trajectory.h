@@ -0,0 +1,111 @@
+#ifndef __CHIKO_TRAJECTORY__
+#define __CHIKO_TRAJECTORY__
+
+#include <Arduino.h>
+
+/*
+    Share of the move duration spent accelerating (and decelerating) when a
+    trapezoidal or S-curve move is planned by duration.
+*/
+#define TRAJECTORY_ACCEL_FRACTION   (float)0.25
+
+/**
+ * @enum TRAJECTORY_PROFILE
+ * @brief Velocity profiles a joint can follow from its current angle to the setpoint.
+ */
+enum TRAJECTORY_PROFILE {
+    CONSTANT_SPEED,  // Constant speed, starts and stops abruptly
+    TRAPEZOIDAL,     // Constant acceleration, cruise, constant deceleration
+    S_CURVE,         // Jerk limited acceleration and deceleration
+    MINIMUM_JERK     // Quintic minimum-jerk polynomial
+};
+
+/**
+ * @class JointTrajectory
+ * @brief Time-parameterized move of one joint between two angles.
+ *        All coefficients are computed once when the move is planned, evaluate() is O(1) per tick.
+ *        A move can start at speed, so a joint retargeted mid-move keeps its velocity
+ *        instead of stopping dead and accelerating again.
+ */
+class JointTrajectory{
+    private:
+        TRAJECTORY_PROFILE Profile = CONSTANT_SPEED;
+        float Start = 0;        // Start angle [deg]
+        float Target = 0;       // Target angle [deg]
+        float Direction = 1;    // +1 or -1, sign of the move
+        float Distance = 0;     // Absolute distance of the move [deg]
+        float Duration = 0;     // Total duration of the move [s]
+        float InvDuration = 0;  // 1 / Duration
+        float StartSpeed = 0;   // Speed at the start along Direction, negative if moving away [deg/s]
+        float PeakSpeed = 0;    // Cruise speed along Direction, negative when overshooting [deg/s]
+        float RampTime = 0;     // Duration of the ramp from the start speed to the cruise speed [s]
+        float CruiseTime = 0;   // Duration of the cruise [s]
+        float StopTime = 0;     // Duration of the ramp from the cruise speed to rest [s]
+        float Quintic[3] = {0}; // Cubic, quartic and quintic coefficients of the minimum-jerk move
+
+        void planPhases(TRAJECTORY_PROFILE profile, float duration, float rampTime, float stopTime);
+        float rampShape(float u);
+        float rampIntegral(float u);
+
+    public:
+        /**
+         * @brief Plan a move that takes exactly the given duration.
+         * @param start Start angle in degrees.
+         * @param target Target angle in degrees.
+         * @param duration Duration of the move in seconds.
+         * @param profile Velocity profile to follow.
+         * @param startSpeed Speed of the joint at the start in degrees/second (default: at rest).
+         */
+        void planDuration(float start, float target, float duration, TRAJECTORY_PROFILE profile, float startSpeed = 0);
+
+        /**
+         * @brief Plan the fastest move within the given speed and acceleration limits.
+         *        A joint too fast to stop at the target overshoots and comes back.
+         * @param start Start angle in degrees.
+         * @param target Target angle in degrees.
+         * @param maxSpeed Maximum speed in degrees/second.
+         * @param maxAcceleration Maximum acceleration in degrees/second^2.
+         * @param profile Velocity profile to follow.
+         * @param startSpeed Speed of the joint at the start in degrees/second (default: at rest).
+         */
+        void planLimits(float start, float target, float maxSpeed, float maxAcceleration, TRAJECTORY_PROFILE profile,
+                        float startSpeed = 0);
+
+        /**
+         * @brief Get the angle of the joint at a given time of the move.
+         * @param t Time since the start of the move in seconds.
+         * @return Angle in degrees, the target angle once t passed the duration.
+         */
+        float evaluate(float t);
+
+        /**
+         * @brief Get the speed of the joint at a given time of the move.
+         * @param t Time since the start of the move in seconds.
+         * @return Speed in degrees/second, 0 once t passed the duration.
+         */
+        float getSpeed(float t);
+
+        /**
+         * @brief Get the total duration of the planned move.
+         * @return Duration in seconds.
+         */
+        float getDuration(void);
+
+        /**
+         * @brief Get the target angle of the planned move.
+         * @return Target angle in degrees.
+         */
+        float getTarget(void);
+
+        /**
+         * @brief Shortest duration of a move from rest within the given limits.
+         * @param distance Distance of the move in degrees.
+         * @param maxSpeed Maximum speed in degrees/second.
+         * @param maxAcceleration Maximum acceleration in degrees/second^2.
+         * @param profile Velocity profile to follow.
+         * @return Duration in seconds.
+         */
+        static float minimumDuration(float distance, float maxSpeed, float maxAcceleration, TRAJECTORY_PROFILE profile);
+};
+
+#endif
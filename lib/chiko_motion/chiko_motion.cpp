@@ -0,0 +1,117 @@
+#include "chiko_motion.h"
+#include <esp_partition.h>
+
+
+bool parseMotionGait(const uint8_t *blob, size_t size, MotionGait *gait) {
+  if (blob == NULL || size < sizeof(MotionGaitHeader)) {
+    return false;
+  }
+  const MotionGaitHeader *header = (const MotionGaitHeader *)blob;
+  if (header->magic != MOTION_GAIT_MAGIC) {
+    return false;
+  }
+  size_t count = (size_t)header->enterCount + header->loopCount + header->exitCount;
+  if (header->loopCount == 0 || size < sizeof(MotionGaitHeader) + count * sizeof(MotionKeyframe)) {
+    return false;
+  }
+  const MotionKeyframe *keyframes = (const MotionKeyframe *)(blob + sizeof(MotionGaitHeader));
+  gait->enter = {keyframes, header->enterCount};
+  gait->loop = {keyframes + header->enterCount, header->loopCount};
+  gait->exit = {keyframes + header->enterCount + header->loopCount, header->exitCount};
+  return true;
+}
+
+bool loadMotionGaitFromPartition(MotionGait *gait, const char *label) {
+  const esp_partition_t *partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+  if (partition == NULL) {
+    return false;
+  }
+  const void *blob;
+  esp_partition_mmap_handle_t handle;
+  if (esp_partition_mmap(partition, 0, partition->size, ESP_PARTITION_MMAP_DATA, &blob, &handle) != ESP_OK) {
+    return false;
+  }
+  // The mapping is kept for the lifetime of the firmware, the keyframes are read in place
+  if (!parseMotionGait((const uint8_t *)blob, partition->size, gait)) {
+    esp_partition_munmap(handle);
+    return false;
+  }
+  return true;
+}
+
+void motionPlayer::attach(Joint *leftFoot, Joint *leftLeg, Joint *rightFoot, Joint *rightLeg) {
+  Joints[MOTION_LEFT_FOOT] = leftFoot;
+  Joints[MOTION_LEFT_LEG] = leftLeg;
+  Joints[MOTION_RIGHT_FOOT] = rightFoot;
+  Joints[MOTION_RIGHT_LEG] = rightLeg;
+  PlayerAction.create(enterRoutine, loopRoutine, exitRoutine, this);
+}
+
+void motionPlayer::load(const MotionGait *gait) {
+  Gait = gait;
+}
+
+void motionPlayer::play(unsigned long long loopCount) {
+  if (Gait == NULL || Joints[0] == NULL) {
+    return;
+  }
+  PlayerAction.begin(loopCount);
+}
+
+void motionPlayer::stop(void) {
+  PlayerAction.stop();
+}
+
+bool motionPlayer::isPlaying(void) {
+  return PlayerAction.actionTaskHandle != NULL;
+}
+
+unsigned long long motionPlayer::getLoopsRemaining(void) {
+  return PlayerAction.LoopItrations;
+}
+
+/*
+    Every keyframe moves all joints for the same time, joints outside the mask
+    hold their angle, so the joints stay in step through the whole motion
+    */
+void motionPlayer::queueKeyframe(const MotionKeyframe &keyframe) {
+  JointTarget targets[MOTION_JOINT_COUNT];
+  for (uint8_t i = 0; i < MOTION_JOINT_COUNT; i++) {
+    if (keyframe.jointMask & MOTION_JOINT_BIT(i)) {
+      HeldAngle[i] = keyframe.angle[i];
+    }
+    Joints[i]->setProfile((TRAJECTORY_PROFILE)keyframe.profile);
+    targets[i] = {Joints[i], HeldAngle[i], 100};
+  }
+  // Blocks until the previous keyframe started, the player stays one pose ahead of the joints
+  queuePose(targets, MOTION_JOINT_COUNT, keyframe.durationMs);
+}
+
+void motionPlayer::playClip(const MotionClip &clip) {
+  for (uint16_t i = 0; i < clip.count; i++) {
+    queueKeyframe(clip.keyframes[i]);
+  }
+}
+
+void motionPlayer::enterRoutine(void *param) {
+  motionPlayer *player = (motionPlayer *)param;
+  for (uint8_t i = 0; i < MOTION_JOINT_COUNT; i++) {
+    player->HeldAngle[i] = player->Joints[i]->JointAngleSetPoint;
+  }
+  player->playClip(player->Gait->enter);
+}
+
+void motionPlayer::loopRoutine(void *param) {
+  motionPlayer *player = (motionPlayer *)param;
+  player->playClip(player->Gait->loop);
+}
+
+void motionPlayer::exitRoutine(void *param) {
+  motionPlayer *player = (motionPlayer *)param;
+  EventBits_t jointBits = 0;
+  player->playClip(player->Gait->exit);
+  for (uint8_t i = 0; i < MOTION_JOINT_COUNT; i++) {
+    jointBits |= getJointBit(player->Joints[i]);
+  }
+  waitTillJointsAvailable(jointBits);
+}
@@ -0,0 +1,147 @@
+#ifndef __CHIKO_MOTION__
+#define __CHIKO_MOTION__
+
+#include <Arduino.h>
+#include <chiko_joint.h>
+#include <chiko_action.h>
+
+/*
+    Motion keyframes
+    A motion is a list of whole-body poses, each reached in a fixed time with a given
+    velocity profile. Angles are whole degrees, the joint order is the order of
+    initialize_joints(): left foot, left leg, right foot, right leg.
+*/
+#define MOTION_JOINT_COUNT    4
+#define MOTION_JOINT_BIT(joint)  (1 << (joint))
+#define MOTION_ALL_JOINTS     0x0F
+
+/*
+    Binary gait blob: MotionGaitHeader followed by the enter, loop and exit keyframes.
+    Little endian, the same layout as the structs below so it can be used in place
+    from memory mapped flash.
+*/
+#define MOTION_GAIT_MAGIC     0x31474B43  // "CKG1"
+#define MOTION_GAIT_PARTITION "gait"      // Label of the data partition holding a gait blob
+
+enum MOTION_JOINT {
+    MOTION_LEFT_FOOT,
+    MOTION_LEFT_LEG,
+    MOTION_RIGHT_FOOT,
+    MOTION_RIGHT_LEG
+};
+
+/**
+ * @struct MotionKeyframe
+ * @brief One pose of a motion, 8 bytes.
+ */
+struct __attribute__((packed)) MotionKeyframe {
+    int8_t angle[MOTION_JOINT_COUNT]; // Target angle of each joint in degrees
+    uint16_t durationMs;              // Time to reach the pose from the previous one
+    uint8_t profile;                  // Velocity profile, see TRAJECTORY_PROFILE
+    uint8_t jointMask;                // Joints moved by this keyframe, the others hold their angle
+};
+
+/**
+ * @struct MotionClip
+ * @brief A sequence of keyframes played back to back.
+ */
+struct MotionClip {
+    const MotionKeyframe *keyframes;
+    uint16_t count;
+};
+
+/**
+ * @struct MotionGait
+ * @brief Enter clip played once, loop clip repeated, exit clip played once when stopped.
+ */
+struct MotionGait {
+    MotionClip enter;
+    MotionClip loop;
+    MotionClip exit;
+};
+
+/**
+ * @struct MotionGaitHeader
+ * @brief Header of a binary gait blob.
+ */
+struct __attribute__((packed)) MotionGaitHeader {
+    uint32_t magic;      // MOTION_GAIT_MAGIC
+    uint16_t enterCount; // Number of enter keyframes
+    uint16_t loopCount;  // Number of loop keyframes
+    uint16_t exitCount;  // Number of exit keyframes
+    uint16_t reserved;
+};
+
+/**
+ * @brief Describe a binary gait blob, the keyframes are used in place.
+ * @param blob Pointer to the blob, must stay valid while the gait is used.
+ * @param size Size of the blob in bytes.
+ * @param gait The gait to fill.
+ * @return True if the blob is a valid gait.
+ */
+bool parseMotionGait(const uint8_t *blob, size_t size, MotionGait *gait);
+
+/**
+ * @brief Map a gait blob stored in a data partition, so gaits can be tuned
+ *        by rewriting the partition without rebuilding the firmware.
+ * @param label Label of the partition (default: MOTION_GAIT_PARTITION).
+ * @param gait The gait to fill.
+ * @return True if the partition exists and holds a valid gait.
+ */
+bool loadMotionGaitFromPartition(MotionGait *gait, const char *label = MOTION_GAIT_PARTITION);
+
+/**
+ * @class motionPlayer
+ * @brief Plays a gait on top of an action. Keyframes are queued to the joint
+ *        scheduler one pose ahead, so each segment starts exactly when the
+ *        previous one ends.
+ */
+class motionPlayer{
+    private:
+        action PlayerAction;
+        Joint *Joints[MOTION_JOINT_COUNT] = {NULL};
+        float HeldAngle[MOTION_JOINT_COUNT] = {0};
+        const MotionGait *Gait = NULL;
+
+        void playClip(const MotionClip &clip);
+        void queueKeyframe(const MotionKeyframe &keyframe);
+        static void enterRoutine(void *param);
+        static void loopRoutine(void *param);
+        static void exitRoutine(void *param);
+
+    public:
+        /**
+         * @brief Bind the player to the robot joints.
+         */
+        void attach(Joint *leftFoot, Joint *leftLeg, Joint *rightFoot, Joint *rightLeg);
+
+        /**
+         * @brief Select the gait played by the next play().
+         * @param gait The gait, must stay valid while it is played.
+         */
+        void load(const MotionGait *gait);
+
+        /**
+         * @brief Play the enter clip, then the loop clip, then the exit clip.
+         * @param loopCount Number of loop iterations (default: until stopped).
+         */
+        void play(unsigned long long loopCount = U_LONGLONGMAX);
+
+        /**
+         * @brief Finish the current loop iteration and play the exit clip.
+         */
+        void stop(void);
+
+        /**
+         * @brief Check whether the player is running.
+         * @return True while a gait is being played.
+         */
+        bool isPlaying(void);
+
+        /**
+         * @brief Get the number of loop iterations left.
+         */
+        unsigned long long getLoopsRemaining(void);
+};
+
+#endif
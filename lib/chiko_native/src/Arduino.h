@@ -0,0 +1,118 @@
+#ifndef __CHIKO_NATIVE_ARDUINO__
+#define __CHIKO_NATIVE_ARDUINO__
+
+/*
+    Host build of the Arduino-ESP32 core subset used by ChikoBot.
+    Time runs on the host steady clock, hardware timers are threads and
+    LEDC writes are recorded (see chiko_native.h) instead of driving pins.
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include "binary.h"
+#include "WString.h"
+#include <RTOS.h>
+
+using std::min;
+using std::max;
+
+#define IRAM_ATTR
+#define PI          3.1415926535897932384626433832795
+#define HALF_PI     1.5707963267948966192313216916398
+#define TWO_PI      6.283185307179586476925286766559
+#define DEG_TO_RAD  0.017453292519943295769236907684886
+#define RAD_TO_DEG  57.295779513082320876798154814105
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT           0x01
+#define OUTPUT          0x03
+#define INPUT_PULLUP    0x05
+#define INPUT_PULLDOWN  0x09
+
+#define RISING    0x01
+#define FALLING   0x02
+#define CHANGE    0x03
+
+#define bit(b)  (1UL << (b))
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+unsigned long millis(void);
+unsigned long micros(void);
+int64_t esp_timer_get_time(void);
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield(void);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+int digitalPinToInterrupt(uint8_t pin);
+void attachInterrupt(uint8_t pin, void (*handler)(void), int mode);
+void detachInterrupt(uint8_t pin);
+
+long map(long x, long in_min, long in_max, long out_min, long out_max);
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+// LEDC, every write is recorded with its time stamp
+bool ledcAttach(uint8_t pin, uint32_t freq, uint8_t resolution);
+bool ledcWrite(uint8_t pin, uint32_t duty);
+
+// Hardware timers, the ISR runs on a dedicated host thread
+struct hw_timer_t;
+hw_timer_t *timerBegin(uint32_t frequency);
+void timerEnd(hw_timer_t *timer);
+void timerAttachInterrupt(hw_timer_t *timer, void (*userFunc)(void));
+void timerAlarm(hw_timer_t *timer, uint64_t alarm_value, bool autoreload, uint64_t reload_count);
+void timerStart(hw_timer_t *timer);
+void timerStop(hw_timer_t *timer);
+
+class HardwareSerial {
+  public:
+    void begin(unsigned long baud);
+    int available(void);
+    int read(void);
+    String readString(void);
+    void flush(void);
+
+    size_t write(uint8_t c);
+    size_t print(const char *s);
+    size_t print(const String &s);
+    size_t print(char c);
+    size_t print(int n, int base = 10);
+    size_t print(unsigned int n, int base = 10);
+    size_t print(long n, int base = 10);
+    size_t print(unsigned long n, int base = 10);
+    size_t print(long long n, int base = 10);
+    size_t print(unsigned long long n, int base = 10);
+    size_t print(double n, int digits = 2);
+    size_t println(void);
+    template <typename T> size_t println(T value) {
+      size_t n = print(value);
+      return n + println();
+    }
+    template <typename T> size_t println(T value, int format) {
+      size_t n = print(value, format);
+      return n + println();
+    }
+    size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+extern HardwareSerial Serial;
+
+// Sketch entry points, called by the host main()
+void setup(void);
+void loop(void);
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef __CHIKO_NATIVE_PREFERENCES__
+#define __CHIKO_NATIVE_PREFERENCES__
+
+#include <Arduino.h>
+
+/*
+    Preferences kept in memory for the lifetime of the program.
+*/
+class Preferences {
+  private:
+    const char *Namespace = NULL;
+    bool ReadOnly = false;
+
+  public:
+    bool begin(const char *name, bool readOnly = false, const char *partition_label = NULL);
+    void end(void);
+    bool clear(void);
+    bool remove(const char *key);
+    bool isKey(const char *key);
+
+    size_t putFloat(const char *key, float value);
+    float getFloat(const char *key, float defaultValue = NAN);
+    size_t putInt(const char *key, int32_t value);
+    int32_t getInt(const char *key, int32_t defaultValue = 0);
+    size_t putUInt(const char *key, uint32_t value);
+    uint32_t getUInt(const char *key, uint32_t defaultValue = 0);
+    size_t putBool(const char *key, bool value);
+    bool getBool(const char *key, bool defaultValue = false);
+};
+
+#endif
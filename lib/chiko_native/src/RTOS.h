@@ -0,0 +1,10 @@
+#ifndef __CHIKO_NATIVE_RTOS__
+#define __CHIKO_NATIVE_RTOS__
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
+
+#endif
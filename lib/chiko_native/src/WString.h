@@ -0,0 +1,48 @@
+#ifndef __CHIKO_NATIVE_WSTRING__
+#define __CHIKO_NATIVE_WSTRING__
+
+#include <stdlib.h>
+#include <algorithm>
+#include <string>
+#include <utility>
+
+/*
+    String of the Arduino core, the members the firmware uses on top of a
+    std::string.
+*/
+class String {
+  private:
+    std::string Text;
+
+  public:
+    String(void) {}
+    String(const char *text) : Text(text != NULL ? text : "") {}
+    String(const std::string &text) : Text(text) {}
+
+    unsigned int length(void) const { return Text.length(); }
+    const char *c_str(void) const { return Text.c_str(); }
+    char operator[](unsigned int index) const { return index < Text.length() ? Text[index] : '\0'; }
+    bool operator==(const char *text) const { return Text == text; }
+    String &operator+=(const String &text) { Text += text.Text; return *this; }
+
+    String substring(unsigned int from) const { return substring(from, length()); }
+    String substring(unsigned int from, unsigned int to) const {
+      if (from > to) {
+        std::swap(from, to);
+      }
+      if (from >= Text.length()) {
+        return String();
+      }
+      return String(Text.substr(from, std::min<unsigned int>(to, Text.length()) - from));
+    }
+
+    void trim(void) {
+      size_t first = Text.find_first_not_of(" \t\r\n\f\v");
+      size_t last = Text.find_last_not_of(" \t\r\n\f\v");
+      Text = first == std::string::npos ? "" : Text.substr(first, last - first + 1);
+    }
+
+    long toInt(void) const { return atol(Text.c_str()); }
+};
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef __CHIKO_NATIVE_WIRE__
+#define __CHIKO_NATIVE_WIRE__
+
+#include <Arduino.h>
+
+#define NATIVE_WIRE_BUFFER_SIZE  128
+
+/*
+    I2C master talking to simulated register devices (see setI2cRegister()).
+    The first byte of a write selects the register, the following bytes are
+    written to consecutive registers. Reads start at the selected register and
+    auto-increment, as on most sensors.
+*/
+class TwoWire {
+  private:
+    uint8_t TxAddress = 0;
+    uint8_t TxBuffer[NATIVE_WIRE_BUFFER_SIZE];
+    size_t TxLength = 0;
+    uint8_t RxBuffer[NATIVE_WIRE_BUFFER_SIZE];
+    size_t RxLength = 0;
+    size_t RxIndex = 0;
+
+  public:
+    bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0);
+    bool setClock(uint32_t frequency);
+    void beginTransmission(uint8_t address);
+    uint8_t endTransmission(bool sendStop = true);
+    size_t requestFrom(uint8_t address, size_t size, bool sendStop = true);
+    size_t write(uint8_t data);
+    size_t write(const uint8_t *data, size_t size);
+    int available(void);
+    int read(void);
+    int peek(void);
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,293 @@
+#include <Arduino.h>
+#include "chiko_native.h"
+#include <stdarg.h>
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <thread>
+
+HardwareSerial Serial;
+
+static std::chrono::steady_clock::time_point startTime(void) {
+  static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  return start;
+}
+
+uint64_t nativeTimeUs(void) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime()).count();
+}
+
+unsigned long millis(void) {
+  return nativeTimeUs() / 1000;
+}
+
+unsigned long micros(void) {
+  return nativeTimeUs();
+}
+
+int64_t esp_timer_get_time(void) {
+  return nativeTimeUs();
+}
+
+void delay(uint32_t ms) {
+  vTaskDelay(pdMS_TO_TICKS(ms));
+}
+
+void delayMicroseconds(uint32_t us) {
+  std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+void yield(void) {
+  std::this_thread::yield();
+}
+
+// ---- GPIO -------------------------------------------------------------------
+
+#define NATIVE_PIN_COUNT  64
+
+static uint8_t pinLevel[NATIVE_PIN_COUNT];
+static void (*pinInterrupt[NATIVE_PIN_COUNT])(void);
+
+void pinMode(uint8_t pin, uint8_t mode) {
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+  if (pin < NATIVE_PIN_COUNT) {
+    pinLevel[pin] = val;
+  }
+}
+
+int digitalRead(uint8_t pin) {
+  return pin < NATIVE_PIN_COUNT ? pinLevel[pin] : LOW;
+}
+
+int digitalPinToInterrupt(uint8_t pin) {
+  return pin;
+}
+
+void attachInterrupt(uint8_t pin, void (*handler)(void), int mode) {
+  if (pin < NATIVE_PIN_COUNT) {
+    pinInterrupt[pin] = handler;
+  }
+}
+
+void detachInterrupt(uint8_t pin) {
+  if (pin < NATIVE_PIN_COUNT) {
+    pinInterrupt[pin] = NULL;
+  }
+}
+
+bool triggerPinInterrupt(uint8_t pin) {
+  if (pin >= NATIVE_PIN_COUNT || pinInterrupt[pin] == NULL) {
+    return false;
+  }
+  pinInterrupt[pin]();
+  return true;
+}
+
+long map(long x, long in_min, long in_max, long out_min, long out_max) {
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+static std::minstd_rand randomEngine;
+
+long random(long howbig) {
+  return howbig > 0 ? (long)(randomEngine() % howbig) : 0;
+}
+
+long random(long howsmall, long howbig) {
+  return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall);
+}
+
+void randomSeed(unsigned long seed) {
+  randomEngine.seed(seed);
+}
+
+// ---- LEDC -------------------------------------------------------------------
+
+struct LedcChannel {
+  uint32_t frequency;
+  uint8_t resolution;
+  float pulseUs;
+};
+
+static std::mutex pwmLock;
+static LedcChannel ledcChannels[NATIVE_PIN_COUNT];
+static PwmWrite pwmLog[NATIVE_PWM_LOG_CAPACITY];
+static size_t pwmWriteCount = 0;
+static void (*pwmWriteHook)(const PwmWrite &write) = NULL;
+
+bool ledcAttach(uint8_t pin, uint32_t freq, uint8_t resolution) {
+  if (pin >= NATIVE_PIN_COUNT || freq == 0) {
+    return false;
+  }
+  std::lock_guard<std::mutex> guard(pwmLock);
+  ledcChannels[pin] = {freq, resolution, 0};
+  return true;
+}
+
+bool ledcWrite(uint8_t pin, uint32_t duty) {
+  if (pin >= NATIVE_PIN_COUNT || ledcChannels[pin].frequency == 0) {
+    return false;
+  }
+  PwmWrite write;
+  void (*hook)(const PwmWrite &write);
+  {
+    std::lock_guard<std::mutex> guard(pwmLock);
+    LedcChannel &channel = ledcChannels[pin];
+    write.timeUs = nativeTimeUs();
+    write.pin = pin;
+    write.duty = duty;
+    write.pulseUs = (float)duty * 1000000 / channel.frequency / (1UL << channel.resolution);
+    channel.pulseUs = write.pulseUs;
+    pwmLog[pwmWriteCount % NATIVE_PWM_LOG_CAPACITY] = write;
+    pwmWriteCount++;
+    hook = pwmWriteHook;
+  }
+  if (hook != NULL) {
+    hook(write);
+  }
+  return true;
+}
+
+size_t getPwmWriteCount(void) {
+  std::lock_guard<std::mutex> guard(pwmLock);
+  return pwmWriteCount;
+}
+
+bool getPwmWrite(size_t index, PwmWrite *write) {
+  std::lock_guard<std::mutex> guard(pwmLock);
+  if (index >= pwmWriteCount || pwmWriteCount - index > NATIVE_PWM_LOG_CAPACITY) {
+    return false;
+  }
+  *write = pwmLog[index % NATIVE_PWM_LOG_CAPACITY];
+  return true;
+}
+
+void clearPwmWrites(void) {
+  std::lock_guard<std::mutex> guard(pwmLock);
+  pwmWriteCount = 0;
+}
+
+void setPwmWriteHook(void (*hook)(const PwmWrite &write)) {
+  std::lock_guard<std::mutex> guard(pwmLock);
+  pwmWriteHook = hook;
+}
+
+float getPwmPulseWidth(uint8_t pin) {
+  std::lock_guard<std::mutex> guard(pwmLock);
+  return pin < NATIVE_PIN_COUNT ? ledcChannels[pin].pulseUs : 0;
+}
+
+// ---- Serial -----------------------------------------------------------------
+// Output goes to stdout, there is no input.
+
+void HardwareSerial::begin(unsigned long baud) {
+}
+
+int HardwareSerial::available(void) {
+  return 0;
+}
+
+int HardwareSerial::read(void) {
+  return -1;
+}
+
+String HardwareSerial::readString(void) {
+  return String();
+}
+
+void HardwareSerial::flush(void) {
+  fflush(stdout);
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+  return fputc(c, stdout) == EOF ? 0 : 1;
+}
+
+size_t HardwareSerial::print(const char *s) {
+  return fputs(s, stdout) < 0 ? 0 : strlen(s);
+}
+
+size_t HardwareSerial::print(const String &s) {
+  return print(s.c_str());
+}
+
+size_t HardwareSerial::print(char c) {
+  return write(c);
+}
+
+static size_t printNumber(unsigned long long n, int base, bool negative) {
+  char buf[8 * sizeof(n) + 2];
+  char *str = &buf[sizeof(buf) - 1];
+  *str = '\0';
+  if (base < 2) {
+    base = 10;
+  }
+  do {
+    int digit = n % base;
+    *--str = digit < 10 ? '0' + digit : 'A' + digit - 10;
+    n /= base;
+  } while (n);
+  if (negative) {
+    *--str = '-';
+  }
+  return Serial.print(str);
+}
+
+size_t HardwareSerial::print(int n, int base) {
+  return print((long long)n, base);
+}
+
+size_t HardwareSerial::print(unsigned int n, int base) {
+  return printNumber(n, base, false);
+}
+
+size_t HardwareSerial::print(long n, int base) {
+  return print((long long)n, base);
+}
+
+size_t HardwareSerial::print(unsigned long n, int base) {
+  return printNumber(n, base, false);
+}
+
+size_t HardwareSerial::print(long long n, int base) {
+  if (base == 10 && n < 0) {
+    return printNumber(-(unsigned long long)n, base, true);
+  }
+  return printNumber((unsigned long long)n, base, false);
+}
+
+size_t HardwareSerial::print(unsigned long long n, int base) {
+  return printNumber(n, base, false);
+}
+
+size_t HardwareSerial::print(double n, int digits) {
+  return printf("%.*f", digits, n);
+}
+
+size_t HardwareSerial::println(void) {
+  return print("\r\n");
+}
+
+size_t HardwareSerial::printf(const char *format, ...) {
+  va_list args;
+  va_start(args, format);
+  int n = vprintf(format, args);
+  va_end(args);
+  return n < 0 ? 0 : n;
+}
+
+// ---- Sketch -----------------------------------------------------------------
+
+int main(void) {
+  setvbuf(stdout, NULL, _IOLBF, 0);
+  startTime();
+  setup();
+  for (;;) {
+    loop();
+    // An empty loop() would otherwise keep one host core busy
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return 0;
+}
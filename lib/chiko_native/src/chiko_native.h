@@ -0,0 +1,78 @@
+#ifndef __CHIKO_NATIVE__
+#define __CHIKO_NATIVE__
+
+/*
+    Simulation interface of the host build.
+    The shim records every LEDC write (i.e. every servo pulse update) with its
+    time stamp, keeps a register file per I2C address and lets the host program
+    fire GPIO interrupts by hand.
+*/
+
+#include <Arduino.h>
+
+// Number of PWM writes kept, older writes are overwritten
+#define NATIVE_PWM_LOG_CAPACITY   (1 << 16)
+
+/**
+ * @struct PwmWrite
+ * @brief One recorded LEDC write.
+ */
+struct PwmWrite {
+    uint64_t timeUs;  // Time of the write since start of the program [uS]
+    uint8_t pin;      // Pin the channel is attached to
+    uint32_t duty;    // Duty written
+    float pulseUs;    // Resulting pulse width [uS]
+};
+
+/**
+ * @brief Time since start of the program in uS, the clock of micros() and of the PWM log.
+ */
+uint64_t nativeTimeUs(void);
+
+/**
+ * @brief Get the number of PWM writes recorded since the last clear.
+ */
+size_t getPwmWriteCount(void);
+
+/**
+ * @brief Get a recorded PWM write.
+ * @param index Index of the write, only the last NATIVE_PWM_LOG_CAPACITY writes are kept.
+ * @param write The record to fill.
+ * @return True if the write is still in the log.
+ */
+bool getPwmWrite(size_t index, PwmWrite *write);
+
+/**
+ * @brief Forget all recorded PWM writes.
+ */
+void clearPwmWrites(void);
+
+/**
+ * @brief Call a function on every PWM write, from the writing thread.
+ * @param hook The function, NULL to remove it.
+ */
+void setPwmWriteHook(void (*hook)(const PwmWrite &write));
+
+/**
+ * @brief Get the last pulse width written to a pin.
+ * @return Pulse width in uS, 0 if the pin was never written.
+ */
+float getPwmPulseWidth(uint8_t pin);
+
+/**
+ * @brief Set a register of the simulated I2C device at an address.
+ */
+void setI2cRegister(uint8_t address, uint8_t reg, uint8_t value);
+
+/**
+ * @brief Get a register of the simulated I2C device at an address.
+ */
+uint8_t getI2cRegister(uint8_t address, uint8_t reg);
+
+/**
+ * @brief Run the interrupt handler attached to a pin, from the calling thread.
+ * @return True if a handler was attached.
+ */
+bool triggerPinInterrupt(uint8_t pin);
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef __CHIKO_NATIVE_FREERTOS__
+#define __CHIKO_NATIVE_FREERTOS__
+
+/*
+    FreeRTOS on host threads. Every task is a std::thread, priorities and core
+    affinity are accepted and ignored, the host scheduler is preemptive on all
+    cores. One tick is one mS.
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdFALSE   ((BaseType_t)0)
+#define pdTRUE    ((BaseType_t)1)
+#define pdFAIL    pdFALSE
+#define pdPASS    pdTRUE
+#define errQUEUE_EMPTY  ((BaseType_t)0)
+#define errQUEUE_FULL   ((BaseType_t)0)
+
+#define configTICK_RATE_HZ      1000
+#define configMAX_PRIORITIES    25
+#define configASSERT(x)         do { if (!(x)) { abort(); } } while (0)
+#define portMAX_DELAY           ((TickType_t)0xffffffffUL)
+#define portTICK_PERIOD_MS      ((TickType_t)1000 / configTICK_RATE_HZ)
+#define pdMS_TO_TICKS(xTimeInMs) ((TickType_t)(((TickType_t)(xTimeInMs) * (TickType_t)configTICK_RATE_HZ) / (TickType_t)1000U))
+#define tskNO_AFFINITY          ((BaseType_t)0x7FFFFFFF)
+
+#define portYIELD_FROM_ISR(...)
+#define portENTER_CRITICAL(mux)
+#define portEXIT_CRITICAL(mux)
+
+#endif
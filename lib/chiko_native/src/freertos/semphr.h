@@ -0,0 +1,21 @@
+#ifndef __CHIKO_NATIVE_SEMPHR__
+#define __CHIKO_NATIVE_SEMPHR__
+
+#include "queue.h"
+
+/*
+    Semaphores are counting queues of zero sized items, as in FreeRTOS.
+    Mutexes are not recursive and have no priority inheritance.
+*/
+typedef QueueHandle_t SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+SemaphoreHandle_t xSemaphoreCreateBinary(void);
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t uxMaxCount, UBaseType_t uxInitialCount);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t xSemaphore, TickType_t xBlockTime);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t xSemaphore);
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t xSemaphore, BaseType_t *pxHigherPriorityTaskWoken);
+
+#define vSemaphoreDelete(xSemaphore) vQueueDelete(xSemaphore)
+
+#endif
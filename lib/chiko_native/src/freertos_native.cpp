@@ -0,0 +1,359 @@
+#include <RTOS.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using std::chrono::steady_clock;
+
+// Thrown to unwind a deleted task back to its thread entry
+struct NativeTaskExit {};
+
+struct NativeTask {
+  std::string name;
+  std::mutex lock;
+  std::condition_variable cv;
+  uint32_t notifyCount = 0;
+  std::atomic<bool> deleted{false};
+};
+
+static thread_local NativeTask *currentTask = NULL;
+
+static steady_clock::time_point tickOrigin(void) {
+  static const steady_clock::time_point origin = steady_clock::now();
+  return origin;
+}
+
+static NativeTask *getCurrentTask(void) {
+  if (currentTask == NULL) {
+    // Threads not created by xTaskCreate (main, timers) get a task on first use
+    currentTask = new NativeTask();
+    currentTask->name = "native";
+  }
+  return currentTask;
+}
+
+/*
+    Block on a condition variable until the predicate holds or the ticks elapsed.
+    Waits in slices so a task deleted by another task leaves at its next wait.
+    */
+template <typename Predicate>
+static bool waitUntil(std::unique_lock<std::mutex> &lock, std::condition_variable &cv, TickType_t ticks, Predicate predicate) {
+  NativeTask *self = getCurrentTask();
+  steady_clock::time_point deadline = steady_clock::time_point::max();
+  if (ticks != portMAX_DELAY) {
+    deadline = steady_clock::now() + std::chrono::milliseconds(ticks * portTICK_PERIOD_MS);
+  }
+  while (!predicate()) {
+    if (self->deleted) {
+      throw NativeTaskExit();
+    }
+    steady_clock::time_point now = steady_clock::now();
+    if (now >= deadline) {
+      return false;
+    }
+    cv.wait_until(lock, std::min(deadline, now + std::chrono::milliseconds(10)));
+  }
+  return true;
+}
+
+// ---- Tasks ------------------------------------------------------------------
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t pvTaskCode, const char *pcName, uint32_t usStackDepth,
+                                   void *pvParameters, UBaseType_t uxPriority, TaskHandle_t *pxCreatedTask,
+                                   BaseType_t xCoreID) {
+  // Tasks are never freed, a stale handle stays valid
+  NativeTask *task = new NativeTask();
+  task->name = pcName != NULL ? pcName : "";
+  if (pxCreatedTask != NULL) {
+    *pxCreatedTask = task;
+  }
+  std::thread([task, pvTaskCode, pvParameters]() {
+    currentTask = task;
+    try {
+      pvTaskCode(pvParameters);
+    } catch (const NativeTaskExit &) {
+    }
+  }).detach();
+  return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t pvTaskCode, const char *pcName, uint32_t usStackDepth,
+                       void *pvParameters, UBaseType_t uxPriority, TaskHandle_t *pxCreatedTask) {
+  return xTaskCreatePinnedToCore(pvTaskCode, pcName, usStackDepth, pvParameters, uxPriority, pxCreatedTask, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t xTask) {
+  NativeTask *self = getCurrentTask();
+  if (xTask == NULL || xTask == self) {
+    throw NativeTaskExit();
+  }
+  std::lock_guard<std::mutex> guard(xTask->lock);
+  xTask->deleted = true;
+  xTask->cv.notify_all();
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+  return getCurrentTask();
+}
+
+void vTaskDelay(TickType_t xTicksToDelay) {
+  NativeTask *self = getCurrentTask();
+  std::unique_lock<std::mutex> lock(self->lock);
+  waitUntil(lock, self->cv, xTicksToDelay, []() { return false; });
+}
+
+BaseType_t xTaskDelayUntil(TickType_t *pxPreviousWakeTime, TickType_t xTimeIncrement) {
+  *pxPreviousWakeTime += xTimeIncrement;
+  TickType_t now = xTaskGetTickCount();
+  TickType_t remaining = *pxPreviousWakeTime - now;
+  if ((int32_t)remaining <= 0) {
+    return pdFALSE;
+  }
+  vTaskDelay(remaining);
+  return pdTRUE;
+}
+
+void vTaskDelayUntil(TickType_t *pxPreviousWakeTime, TickType_t xTimeIncrement) {
+  xTaskDelayUntil(pxPreviousWakeTime, xTimeIncrement);
+}
+
+TickType_t xTaskGetTickCount(void) {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(steady_clock::now() - tickOrigin()).count() / portTICK_PERIOD_MS;
+}
+
+TickType_t xTaskGetTickCountFromISR(void) {
+  return xTaskGetTickCount();
+}
+
+void vTaskSuspendAll(void) {
+  if (getCurrentTask()->deleted) {
+    throw NativeTaskExit();
+  }
+}
+
+BaseType_t xTaskResumeAll(void) {
+  return pdFALSE;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t xClearCountOnExit, TickType_t xTicksToWait) {
+  NativeTask *self = getCurrentTask();
+  std::unique_lock<std::mutex> lock(self->lock);
+  waitUntil(lock, self->cv, xTicksToWait, [self]() { return self->notifyCount > 0; });
+  uint32_t count = self->notifyCount;
+  if (count > 0) {
+    self->notifyCount = xClearCountOnExit ? 0 : count - 1;
+  }
+  return count;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t xTaskToNotify) {
+  std::lock_guard<std::mutex> guard(xTaskToNotify->lock);
+  xTaskToNotify->notifyCount++;
+  xTaskToNotify->cv.notify_all();
+  return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t xTaskToNotify, BaseType_t *pxHigherPriorityTaskWoken) {
+  xTaskNotifyGive(xTaskToNotify);
+  if (pxHigherPriorityTaskWoken != NULL) {
+    *pxHigherPriorityTaskWoken = pdFALSE;
+  }
+}
+
+BaseType_t xPortGetCoreID(void) {
+  return 0;
+}
+
+// ---- Event groups -----------------------------------------------------------
+
+struct NativeEventGroup {
+  std::mutex lock;
+  std::condition_variable cv;
+  EventBits_t bits = 0;
+};
+
+EventGroupHandle_t xEventGroupCreate(void) {
+  return new NativeEventGroup();
+}
+
+void vEventGroupDelete(EventGroupHandle_t xEventGroup) {
+  delete xEventGroup;
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToSet) {
+  std::lock_guard<std::mutex> guard(xEventGroup->lock);
+  xEventGroup->bits |= uxBitsToSet;
+  xEventGroup->cv.notify_all();
+  return xEventGroup->bits;
+}
+
+BaseType_t xEventGroupSetBitsFromISR(EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToSet,
+                                     BaseType_t *pxHigherPriorityTaskWoken) {
+  xEventGroupSetBits(xEventGroup, uxBitsToSet);
+  if (pxHigherPriorityTaskWoken != NULL) {
+    *pxHigherPriorityTaskWoken = pdFALSE;
+  }
+  return pdPASS;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToClear) {
+  std::lock_guard<std::mutex> guard(xEventGroup->lock);
+  EventBits_t bits = xEventGroup->bits;
+  xEventGroup->bits &= ~uxBitsToClear;
+  return bits;
+}
+
+EventBits_t xEventGroupGetBits(EventGroupHandle_t xEventGroup) {
+  std::lock_guard<std::mutex> guard(xEventGroup->lock);
+  return xEventGroup->bits;
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToWaitFor,
+                                const BaseType_t xClearOnExit, const BaseType_t xWaitForAllBits,
+                                TickType_t xTicksToWait) {
+  std::unique_lock<std::mutex> lock(xEventGroup->lock);
+  auto satisfied = [&]() {
+    EventBits_t set = xEventGroup->bits & uxBitsToWaitFor;
+    return xWaitForAllBits ? set == uxBitsToWaitFor : set != 0;
+  };
+  bool met = waitUntil(lock, xEventGroup->cv, xTicksToWait, satisfied);
+  EventBits_t bits = xEventGroup->bits;
+  if (met && xClearOnExit) {
+    xEventGroup->bits &= ~uxBitsToWaitFor;
+  }
+  return bits;
+}
+
+// ---- Queues and semaphores --------------------------------------------------
+
+struct NativeQueue {
+  std::mutex lock;
+  std::condition_variable cv;
+  UBaseType_t length;
+  UBaseType_t itemSize;
+  std::deque<std::vector<uint8_t>> items;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t uxQueueLength, UBaseType_t uxItemSize) {
+  NativeQueue *queue = new NativeQueue();
+  queue->length = uxQueueLength;
+  queue->itemSize = uxItemSize;
+  return queue;
+}
+
+void vQueueDelete(QueueHandle_t xQueue) {
+  delete xQueue;
+}
+
+static BaseType_t queueSend(QueueHandle_t xQueue, const void *pvItemToQueue, TickType_t xTicksToWait, bool front) {
+  std::unique_lock<std::mutex> lock(xQueue->lock);
+  if (!waitUntil(lock, xQueue->cv, xTicksToWait, [xQueue]() { return xQueue->items.size() < xQueue->length; })) {
+    return errQUEUE_FULL;
+  }
+  const uint8_t *item = (const uint8_t *)pvItemToQueue;
+  std::vector<uint8_t> copy(item, item + (item != NULL ? xQueue->itemSize : 0));
+  if (front) {
+    xQueue->items.push_front(std::move(copy));
+  } else {
+    xQueue->items.push_back(std::move(copy));
+  }
+  xQueue->cv.notify_all();
+  return pdPASS;
+}
+
+BaseType_t xQueueSend(QueueHandle_t xQueue, const void *pvItemToQueue, TickType_t xTicksToWait) {
+  return queueSend(xQueue, pvItemToQueue, xTicksToWait, false);
+}
+
+BaseType_t xQueueSendToFront(QueueHandle_t xQueue, const void *pvItemToQueue, TickType_t xTicksToWait) {
+  return queueSend(xQueue, pvItemToQueue, xTicksToWait, true);
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t xQueue, const void *pvItemToQueue, BaseType_t *pxHigherPriorityTaskWoken) {
+  if (pxHigherPriorityTaskWoken != NULL) {
+    *pxHigherPriorityTaskWoken = pdFALSE;
+  }
+  return queueSend(xQueue, pvItemToQueue, 0, false);
+}
+
+BaseType_t xQueueOverwrite(QueueHandle_t xQueue, const void *pvItemToQueue) {
+  {
+    std::lock_guard<std::mutex> guard(xQueue->lock);
+    xQueue->items.clear();
+  }
+  return queueSend(xQueue, pvItemToQueue, 0, false);
+}
+
+static BaseType_t queueReceive(QueueHandle_t xQueue, void *pvBuffer, TickType_t xTicksToWait, bool remove) {
+  std::unique_lock<std::mutex> lock(xQueue->lock);
+  if (!waitUntil(lock, xQueue->cv, xTicksToWait, [xQueue]() { return !xQueue->items.empty(); })) {
+    return errQUEUE_EMPTY;
+  }
+  if (pvBuffer != NULL && xQueue->itemSize > 0) {
+    memcpy(pvBuffer, xQueue->items.front().data(), xQueue->itemSize);
+  }
+  if (remove) {
+    xQueue->items.pop_front();
+    xQueue->cv.notify_all();
+  }
+  return pdPASS;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t xQueue, void *pvBuffer, TickType_t xTicksToWait) {
+  return queueReceive(xQueue, pvBuffer, xTicksToWait, true);
+}
+
+BaseType_t xQueuePeek(QueueHandle_t xQueue, void *pvBuffer, TickType_t xTicksToWait) {
+  return queueReceive(xQueue, pvBuffer, xTicksToWait, false);
+}
+
+BaseType_t xQueueReset(QueueHandle_t xQueue) {
+  std::lock_guard<std::mutex> guard(xQueue->lock);
+  xQueue->items.clear();
+  xQueue->cv.notify_all();
+  return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t xQueue) {
+  std::lock_guard<std::mutex> guard(xQueue->lock);
+  return xQueue->items.size();
+}
+
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t xQueue) {
+  std::lock_guard<std::mutex> guard(xQueue->lock);
+  return xQueue->length - xQueue->items.size();
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t uxMaxCount, UBaseType_t uxInitialCount) {
+  QueueHandle_t queue = xQueueCreate(uxMaxCount, 0);
+  for (UBaseType_t i = 0; i < uxInitialCount; i++) {
+    xQueueSend(queue, NULL, 0);
+  }
+  return queue;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void) {
+  return xSemaphoreCreateCounting(1, 0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) {
+  return xSemaphoreCreateCounting(1, 1);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t xSemaphore, TickType_t xBlockTime) {
+  return xQueueReceive(xSemaphore, NULL, xBlockTime);
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t xSemaphore) {
+  return xQueueSend(xSemaphore, NULL, 0);
+}
+
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t xSemaphore, BaseType_t *pxHigherPriorityTaskWoken) {
+  return xQueueSendFromISR(xSemaphore, NULL, pxHigherPriorityTaskWoken);
+}
@@ -0,0 +1,94 @@
+#include "Preferences.h"
+#include <map>
+#include <mutex>
+#include <string>
+
+// Every value is stored as a double, keyed by namespace and key
+static std::mutex preferencesLock;
+static std::map<std::string, double> preferencesStore;
+
+static std::string preferencesKey(const char *name, const char *key) {
+  return std::string(name != NULL ? name : "") + "/" + key;
+}
+
+bool Preferences::begin(const char *name, bool readOnly, const char *partition_label) {
+  Namespace = name;
+  ReadOnly = readOnly;
+  return true;
+}
+
+void Preferences::end(void) {
+  Namespace = NULL;
+}
+
+bool Preferences::clear(void) {
+  if (Namespace == NULL || ReadOnly) {
+    return false;
+  }
+  std::lock_guard<std::mutex> guard(preferencesLock);
+  std::string prefix = preferencesKey(Namespace, "");
+  for (auto it = preferencesStore.begin(); it != preferencesStore.end();) {
+    it = it->first.compare(0, prefix.size(), prefix) == 0 ? preferencesStore.erase(it) : std::next(it);
+  }
+  return true;
+}
+
+bool Preferences::remove(const char *key) {
+  if (Namespace == NULL || ReadOnly) {
+    return false;
+  }
+  std::lock_guard<std::mutex> guard(preferencesLock);
+  return preferencesStore.erase(preferencesKey(Namespace, key)) > 0;
+}
+
+bool Preferences::isKey(const char *key) {
+  std::lock_guard<std::mutex> guard(preferencesLock);
+  return Namespace != NULL && preferencesStore.count(preferencesKey(Namespace, key)) > 0;
+}
+
+static size_t putValue(const char *name, bool readOnly, const char *key, double value, size_t size) {
+  if (name == NULL || readOnly) {
+    return 0;
+  }
+  std::lock_guard<std::mutex> guard(preferencesLock);
+  preferencesStore[preferencesKey(name, key)] = value;
+  return size;
+}
+
+static double getValue(const char *name, const char *key, double defaultValue) {
+  std::lock_guard<std::mutex> guard(preferencesLock);
+  auto it = preferencesStore.find(preferencesKey(name, key));
+  return (name == NULL || it == preferencesStore.end()) ? defaultValue : it->second;
+}
+
+size_t Preferences::putFloat(const char *key, float value) {
+  return putValue(Namespace, ReadOnly, key, value, sizeof(value));
+}
+
+float Preferences::getFloat(const char *key, float defaultValue) {
+  return getValue(Namespace, key, defaultValue);
+}
+
+size_t Preferences::putInt(const char *key, int32_t value) {
+  return putValue(Namespace, ReadOnly, key, value, sizeof(value));
+}
+
+int32_t Preferences::getInt(const char *key, int32_t defaultValue) {
+  return getValue(Namespace, key, defaultValue);
+}
+
+size_t Preferences::putUInt(const char *key, uint32_t value) {
+  return putValue(Namespace, ReadOnly, key, value, sizeof(value));
+}
+
+uint32_t Preferences::getUInt(const char *key, uint32_t defaultValue) {
+  return getValue(Namespace, key, defaultValue);
+}
+
+size_t Preferences::putBool(const char *key, bool value) {
+  return putValue(Namespace, ReadOnly, key, value, sizeof(value));
+}
+
+bool Preferences::getBool(const char *key, bool defaultValue) {
+  return getValue(Namespace, key, defaultValue) != 0;
+}
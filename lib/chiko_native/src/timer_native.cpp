@@ -0,0 +1,104 @@
+#include <Arduino.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+using std::chrono::steady_clock;
+
+/*
+    Each hardware timer is a thread sleeping until the next alarm. The alarm
+    keeps its phase, a late wakeup is not accumulated into the following alarms.
+    */
+struct hw_timer_t {
+  std::mutex lock;
+  std::condition_variable cv;
+  std::thread thread;
+  uint32_t frequency = 0;
+  void (*isr)(void) = NULL;
+  uint64_t alarmValue = 0;
+  bool autoreload = false;
+  bool running = false;
+  bool quit = false;
+  uint32_t generation = 0;  // Bumped whenever the alarm is reprogrammed
+};
+
+static void timerThread(hw_timer_t *timer) {
+  std::unique_lock<std::mutex> lock(timer->lock);
+  while (!timer->quit) {
+    if (!timer->running || timer->alarmValue == 0) {
+      timer->cv.wait(lock);
+      continue;
+    }
+    uint32_t generation = timer->generation;
+    std::chrono::nanoseconds period((int64_t)(timer->alarmValue * 1000000000ULL / timer->frequency));
+    steady_clock::time_point alarm = steady_clock::now() + period;
+    while (!timer->quit && timer->running && timer->generation == generation) {
+      if (timer->cv.wait_until(lock, alarm) != std::cv_status::timeout) {
+        continue;
+      }
+      void (*isr)(void) = timer->isr;
+      if (!timer->autoreload) {
+        timer->running = false;
+      }
+      lock.unlock();
+      if (isr != NULL) {
+        isr();
+      }
+      lock.lock();
+      alarm += period;
+      steady_clock::time_point now = steady_clock::now();
+      if (alarm < now) {
+        alarm += ((now - alarm) / period + 1) * period;
+      }
+    }
+  }
+}
+
+hw_timer_t *timerBegin(uint32_t frequency) {
+  if (frequency == 0) {
+    return NULL;
+  }
+  hw_timer_t *timer = new hw_timer_t();
+  timer->frequency = frequency;
+  timer->running = true;
+  timer->thread = std::thread(timerThread, timer);
+  return timer;
+}
+
+void timerEnd(hw_timer_t *timer) {
+  {
+    std::lock_guard<std::mutex> guard(timer->lock);
+    timer->quit = true;
+    timer->cv.notify_all();
+  }
+  timer->thread.join();
+  delete timer;
+}
+
+void timerAttachInterrupt(hw_timer_t *timer, void (*userFunc)(void)) {
+  std::lock_guard<std::mutex> guard(timer->lock);
+  timer->isr = userFunc;
+}
+
+void timerAlarm(hw_timer_t *timer, uint64_t alarm_value, bool autoreload, uint64_t reload_count) {
+  std::lock_guard<std::mutex> guard(timer->lock);
+  timer->alarmValue = alarm_value;
+  timer->autoreload = autoreload;
+  timer->running = true;
+  timer->generation++;
+  timer->cv.notify_all();
+}
+
+void timerStart(hw_timer_t *timer) {
+  std::lock_guard<std::mutex> guard(timer->lock);
+  timer->running = true;
+  timer->generation++;
+  timer->cv.notify_all();
+}
+
+void timerStop(hw_timer_t *timer) {
+  std::lock_guard<std::mutex> guard(timer->lock);
+  timer->running = false;
+  timer->cv.notify_all();
+}
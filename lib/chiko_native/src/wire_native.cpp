@@ -0,0 +1,87 @@
+#include "Wire.h"
+#include "chiko_native.h"
+#include <mutex>
+
+TwoWire Wire;
+
+static std::mutex i2cLock;
+static uint8_t i2cRegisters[128][256];
+static uint8_t i2cRegisterPointer[128];
+
+void setI2cRegister(uint8_t address, uint8_t reg, uint8_t value) {
+  std::lock_guard<std::mutex> guard(i2cLock);
+  i2cRegisters[address & 0x7F][reg] = value;
+}
+
+uint8_t getI2cRegister(uint8_t address, uint8_t reg) {
+  std::lock_guard<std::mutex> guard(i2cLock);
+  return i2cRegisters[address & 0x7F][reg];
+}
+
+bool TwoWire::begin(int sda, int scl, uint32_t frequency) {
+  return true;
+}
+
+bool TwoWire::setClock(uint32_t frequency) {
+  return true;
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+  TxAddress = address & 0x7F;
+  TxLength = 0;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+  std::lock_guard<std::mutex> guard(i2cLock);
+  if (TxLength > 0) {
+    uint8_t reg = TxBuffer[0];
+    for (size_t i = 1; i < TxLength; i++) {
+      i2cRegisters[TxAddress][reg++] = TxBuffer[i];
+    }
+    i2cRegisterPointer[TxAddress] = TxBuffer[0];
+  }
+  TxLength = 0;
+  return 0;
+}
+
+size_t TwoWire::requestFrom(uint8_t address, size_t size, bool sendStop) {
+  std::lock_guard<std::mutex> guard(i2cLock);
+  address &= 0x7F;
+  size = min(size, (size_t)NATIVE_WIRE_BUFFER_SIZE);
+  uint8_t reg = i2cRegisterPointer[address];
+  for (size_t i = 0; i < size; i++) {
+    RxBuffer[i] = i2cRegisters[address][reg++];
+  }
+  i2cRegisterPointer[address] = reg;
+  RxLength = size;
+  RxIndex = 0;
+  return size;
+}
+
+size_t TwoWire::write(uint8_t data) {
+  if (TxLength >= NATIVE_WIRE_BUFFER_SIZE) {
+    return 0;
+  }
+  TxBuffer[TxLength++] = data;
+  return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t size) {
+  size_t written = 0;
+  while (written < size && write(data[written])) {
+    written++;
+  }
+  return written;
+}
+
+int TwoWire::available(void) {
+  return RxLength - RxIndex;
+}
+
+int TwoWire::read(void) {
+  return RxIndex < RxLength ? RxBuffer[RxIndex++] : -1;
+}
+
+int TwoWire::peek(void) {
+  return RxIndex < RxLength ? RxBuffer[RxIndex] : -1;
+}
@@ -0,0 +1,195 @@
+#include "chiko_teleop.h"
+
+/*
+    Stick or trigger as a float, sticks -1 to 1 and triggers 0 to 1
+    */
+static float readAxis(const BLEControlsEvent &controls, int8_t axis) {
+  switch (axis) {
+    case BLEAxisLeftStickX: return controls.leftStickX();
+    case BLEAxisLeftStickY: return controls.leftStickY();
+    case BLEAxisRightStickX: return controls.rightStickX();
+    case BLEAxisRightStickY: return controls.rightStickY();
+    case BLEAxisLeftTrigger: return controls.leftTrigger();
+    case BLEAxisRightTrigger: return controls.rightTrigger();
+    default: return 0;
+  }
+}
+
+/*
+    Runs in the joint scheduler task before the setpoints are read, a pose committed
+    here is written to the servos in the same tick
+    */
+void TeleopController::tickHook(void *param) {
+  TeleopController *teleop = (TeleopController *)param;
+  teleop->step(getJointUpdateRate() / (float)1000);
+}
+
+void TeleopController::latencyCallback(void *param, uint32_t latencyUs) {
+  TeleopController *teleop = (TeleopController *)param;
+  teleop->LatencySequence.fetch_add(1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  TeleopLatency &latency = teleop->Latency;
+  latency.lastUs = latencyUs;
+  latency.maxUs = max(latency.maxUs, latencyUs);
+  latency.count++;
+  teleop->LatencyTotalUs += latencyUs;
+  latency.meanUs = teleop->LatencyTotalUs / latency.count;
+  if (latencyUs > TELEOP_LATENCY_BUDGET_US) {
+    latency.overBudget++;
+  }
+  teleop->LatencySequence.fetch_add(1, std::memory_order_release);
+}
+
+void TeleopController::step(float dt) {
+  if (ResetLatency.exchange(false)) {
+    LatencySequence.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    Latency = TeleopLatency();
+    LatencyTotalUs = 0;
+    LatencySequence.fetch_add(1, std::memory_order_release);
+  }
+  if (!Enabled.load() || Controller == NULL) {
+    return;
+  }
+  bool restarted = Restart.exchange(false);
+  if (restarted) {
+    for (uint8_t i = 0; i < BindingCount; i++) {
+      Output[i] = Bindings[i].joint != NULL ? Bindings[i].joint->JointAngle : Bindings[i].offset;
+    }
+  }
+
+  // Nothing read means no controller, every binding returns to rest. The controls
+  // found when enabling may be old, they are not timed.
+  BLEControlsEvent controls;
+  uint32_t sequence = Controller->readControls(controls);
+  uint32_t inputUs = 0;
+  if (sequence != LastSequence) {
+    LastSequence = sequence;
+    inputUs = sequence != 0 && !restarted ? controls.timeUs : 0;
+  }
+
+  JointTarget targets[TELEOP_MAX_BINDINGS];
+  size_t count = 0;
+  for (uint8_t i = 0; i < BindingCount; i++) {
+    const TeleopBinding &binding = Bindings[i];
+    float input = binding.axis >= 0 ? readAxis(controls, binding.axis) : ((controls.buttons & binding.buttons) ? 1 : 0);
+    if (fabsf(input) < binding.deadzone) {
+      input = 0;
+    }
+    input = (1 - binding.expo) * input + binding.expo * input * input * input;
+    float output = binding.offset + binding.scale * input;
+    if (binding.rate > 0) {
+      float maxStep = binding.rate * dt;
+      output = Output[i] + constrain(output - Output[i], -maxStep, maxStep);
+    }
+    if (output == Output[i]) {
+      continue;
+    }
+    Output[i] = output;
+    if (binding.joint != NULL) {
+      targets[count++] = {binding.joint, output, 100};
+    } else {
+      binding.parameter(output);
+    }
+  }
+  // Only the step that sees a new notification carries its time, a move still
+  // catching up with the rate limit is not an input of its own
+  if (count > 0) {
+    commitInputPose(targets, count, inputUs);
+  }
+}
+
+void TeleopController::begin(BLEController *controller) {
+  if (Controller != NULL) {
+    return;
+  }
+  Controller = controller;
+  TickHook.hook = tickHook;
+  TickHook.param = this;
+  LatencyCallback.callback = latencyCallback;
+  LatencyCallback.param = this;
+  setJointTickHook(&TickHook);
+  setJointLatencyCallback(&LatencyCallback);
+}
+
+int TeleopController::bind(const TeleopBinding &binding) {
+  if (BindingCount >= TELEOP_MAX_BINDINGS || (binding.joint == NULL && binding.parameter == NULL)) {
+    return -1;
+  }
+  Bindings[BindingCount] = binding;
+  Output[BindingCount] = binding.joint != NULL ? binding.joint->JointAngle : binding.offset;
+  return BindingCount++;
+}
+
+int TeleopController::bindAxis(BLEInputAxis axis, Joint *joint, float scale, float expo, float rate) {
+  TeleopBinding binding;
+  binding.axis = axis;
+  binding.joint = joint;
+  binding.scale = scale;
+  binding.expo = expo;
+  binding.rate = rate;
+  return bind(binding);
+}
+
+int TeleopController::bindAxis(BLEInputAxis axis, void (*parameter)(float value), float scale, float expo, float rate) {
+  TeleopBinding binding;
+  binding.axis = axis;
+  binding.parameter = parameter;
+  binding.scale = scale;
+  binding.expo = expo;
+  binding.rate = rate;
+  return bind(binding);
+}
+
+int TeleopController::bindButtons(uint16_t buttons, Joint *joint, float angle, float rate) {
+  TeleopBinding binding;
+  binding.buttons = buttons;
+  binding.joint = joint;
+  binding.scale = angle;
+  binding.rate = rate;
+  return bind(binding);
+}
+
+int TeleopController::bindButtons(uint16_t buttons, void (*parameter)(float value), float value, float rate) {
+  TeleopBinding binding;
+  binding.buttons = buttons;
+  binding.parameter = parameter;
+  binding.scale = value;
+  binding.rate = rate;
+  return bind(binding);
+}
+
+void TeleopController::clearBindings(void) {
+  if (!Enabled.load()) {
+    BindingCount = 0;
+  }
+}
+
+void TeleopController::enable(void) {
+  Restart.store(true);
+  Enabled.store(true);
+}
+
+void TeleopController::disable(void) {
+  Enabled.store(false);
+}
+
+bool TeleopController::isEnabled(void) {
+  return Enabled.load();
+}
+
+TeleopLatency TeleopController::getLatency(void) {
+  TeleopLatency latency;
+  uint32_t seqBegin, seqEnd;
+  do {
+    seqBegin = LatencySequence.load(std::memory_order_acquire);
+    latency = Latency;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    seqEnd = LatencySequence.load(std::memory_order_relaxed);
+  } while ((seqBegin & 1) || seqBegin != seqEnd);
+  return latency;
+}
+
+void TeleopController::resetLatency(void) {
+  ResetLatency.store(true);
+}
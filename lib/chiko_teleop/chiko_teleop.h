@@ -0,0 +1,177 @@
+#ifndef __CHIKO_TELEOP__
+#define __CHIKO_TELEOP__
+
+#include <Arduino.h>
+#include <RTOS.h>
+#include <atomic>
+#include <BLEController.h>
+#include <chiko_joint.h>
+
+/*
+    Teleoperation
+    Binds the sticks, triggers and buttons of a BLE gamepad to joints and gait
+    parameters. The bindings are evaluated by the joint scheduler at the start of
+    every tick, from the controls the NimBLE host task published last, so a
+    notification reaches the servos in the first tick after it arrived. There is
+    no polling task and no dispatch queue in between, the time from a
+    notification to the servo write is measured and stays within one update
+    period and the tick itself.
+*/
+#define TELEOP_MAX_BINDINGS       8
+#define TELEOP_DEFAULT_DEADZONE   (float)0.10   // Same as DEADZONE of dz() in chiko_bController
+#define TELEOP_DEFAULT_RATE       (float)DEFAULT_JOINT_SPEED // [deg/s] Fastest change of a joint binding
+#define TELEOP_LATENCY_BUDGET_US  (JOINT_UPDATE_RATE * 1000 + 2000) // [uS] One update period and the tick
+
+/**
+ * @struct TeleopBinding
+ * @brief One entry of the mapping table: output = offset + scale * expo(dz(input)),
+ *        changing by at most rate per second.
+ */
+struct TeleopBinding {
+    int8_t axis = -1;               // BLEInputAxis driving the binding, -1 for buttons
+    uint16_t buttons = 0;           // BLEControlsButton bits, the input is 1 while any of them is held
+    Joint *joint = NULL;            // Joint whose angle follows the output, or NULL
+    void (*parameter)(float value) = NULL; // Called with the output when it changes, if joint is NULL
+    float scale = 90;               // Output at full deflection, e.g. degrees for a joint
+    float offset = 0;               // Output at rest
+    float expo = 0;                 // 0 linear to 1 cubic, softer around the center
+    float rate = 0;                 // Fastest change of the output per second, 0 for no limit
+    float deadzone = TELEOP_DEFAULT_DEADZONE; // Inputs closer to 0 are 0
+};
+
+/**
+ * @struct TeleopLatency
+ * @brief Time from a controller notification to the servo write that follows it.
+ */
+struct TeleopLatency {
+    uint32_t lastUs = 0;        // Latest input [uS]
+    uint32_t meanUs = 0;        // Mean since the last reset [uS]
+    uint32_t maxUs = 0;         // Slowest since the last reset [uS]
+    uint32_t count = 0;         // Inputs measured
+    uint32_t overBudget = 0;    // Inputs slower than TELEOP_LATENCY_BUDGET_US
+};
+
+/**
+ * @class TeleopController
+ * @brief Drives joints and gait parameters from a BLE gamepad through a mapping table.
+ */
+class TeleopController{
+    private:
+        BLEController *Controller = NULL;
+        TeleopBinding Bindings[TELEOP_MAX_BINDINGS];
+        float Output[TELEOP_MAX_BINDINGS] = {0};
+        uint8_t BindingCount = 0;
+        uint32_t LastSequence = 0;          // Sequence of the controls read in the last step
+        std::atomic<bool> Enabled{false};
+        std::atomic<bool> Restart{false};   // Outputs start over from the joints on the next step
+        std::atomic<bool> ResetLatency{false};
+
+        // Written by the scheduler task only, read through the sequence lock
+        std::atomic<uint32_t> LatencySequence{0};
+        TeleopLatency Latency;
+        uint64_t LatencyTotalUs = 0;
+
+        JointTickHook TickHook;             // Installed in the scheduler by begin()
+        JointLatencyCallback LatencyCallback;
+
+        static void tickHook(void *param);
+        static void latencyCallback(void *param, uint32_t latencyUs);
+
+    public:
+        /**
+         * @brief Read the controls of a controller and hook into the joint scheduler.
+         *        The controller starts disabled.
+         * @param controller The controller, must stay valid.
+         */
+        void begin(BLEController *controller);
+
+        /**
+         * @brief Add an entry to the mapping table. Bind before enable(), the table is
+         *        read by the joint scheduler while enabled.
+         * @param binding The entry.
+         * @return Index of the entry, -1 if the table is full or the entry has no target.
+         */
+        int bind(const TeleopBinding &binding);
+
+        /**
+         * @brief Move a joint with a stick or trigger.
+         * @param axis The stick or trigger.
+         * @param joint The joint.
+         * @param scale Angle at full deflection in degrees.
+         * @param expo 0 linear to 1 cubic (default: linear).
+         * @param rate Fastest change in degrees/second (default: TELEOP_DEFAULT_RATE).
+         * @return Index of the entry, -1 if the table is full.
+         */
+        int bindAxis(BLEInputAxis axis, Joint *joint, float scale, float expo = 0, float rate = TELEOP_DEFAULT_RATE);
+
+        /**
+         * @brief Set a gait parameter with a stick or trigger.
+         * @param axis The stick or trigger.
+         * @param parameter Called from the scheduler task with the new value, must not block.
+         * @param scale Value at full deflection.
+         * @param expo 0 linear to 1 cubic (default: linear).
+         * @param rate Fastest change per second, 0 for no limit (default: 0).
+         * @return Index of the entry, -1 if the table is full.
+         */
+        int bindAxis(BLEInputAxis axis, void (*parameter)(float value), float scale, float expo = 0, float rate = 0);
+
+        /**
+         * @brief Move a joint to an angle while any of the buttons is held.
+         * @param buttons BLEControlsButton bits.
+         * @param joint The joint.
+         * @param angle Angle while held, the joint returns to 0 when released.
+         * @param rate Fastest change in degrees/second (default: TELEOP_DEFAULT_RATE).
+         * @return Index of the entry, -1 if the table is full.
+         */
+        int bindButtons(uint16_t buttons, Joint *joint, float angle, float rate = TELEOP_DEFAULT_RATE);
+
+        /**
+         * @brief Set a gait parameter while any of the buttons is held.
+         * @param buttons BLEControlsButton bits.
+         * @param parameter Called from the scheduler task with the new value, must not block.
+         * @param value Value while held, 0 when released.
+         * @param rate Fastest change per second, 0 for no limit (default: 0).
+         * @return Index of the entry, -1 if the table is full.
+         */
+        int bindButtons(uint16_t buttons, void (*parameter)(float value), float value, float rate = 0);
+
+        /**
+         * @brief Remove all entries, only while disabled.
+         */
+        void clearBindings(void);
+
+        /**
+         * @brief Start driving the bound joints and parameters. The joints move on from
+         *        where they are, actions should not move them meanwhile.
+         */
+        void enable(void);
+
+        /**
+         * @brief Stop driving, the joints hold their angle.
+         */
+        void disable(void);
+
+        /**
+         * @brief Check if the bindings are driven.
+         */
+        bool isEnabled(void);
+
+        /**
+         * @brief Get the latency from the controller notifications to the servo writes.
+         */
+        TeleopLatency getLatency(void);
+
+        /**
+         * @brief Start the latency figures over, from the next input on.
+         */
+        void resetLatency(void);
+
+        /**
+         * @brief Evaluate the bindings once and commit the changed joints. Normally called
+         *        by the joint scheduler at the start of every tick.
+         * @param dt Time since the last step in seconds.
+         */
+        void step(float dt);
+};
+
+#endif
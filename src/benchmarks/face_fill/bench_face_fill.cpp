@@ -0,0 +1,207 @@
+/**
+ * @file bench_face_fill.cpp
+ * @brief Host benchmark of the chiko_fill kernels (env:Benchmark_face_fill).
+ *
+ * Draws the same random lines, boxes and rounded boxes into two frame buffers
+ * of the face display (SSD1309 128x64, full buffer), once with the stock U8g2
+ * line function and once with the chiko_fill kernels.
+ *
+ * Reported figures, for each shape:
+ * 1. **Throughput:** pixels per second of both paths and the speedup. The
+ *    eyes case is the frame of the face, two 40x40 boxes with 10 pixel corners.
+ * 2. **Mismatches:** shapes after which the two buffers differ. The kernels must
+ *    draw exactly what U8g2 draws, in every draw color and clipped at the edges.
+ *
+ * The program exits with a non-zero status if a figure exceeds its limit:
+ *   pio run -e Benchmark_face_fill -t exec
+ */
+
+#include <Arduino.h>
+#include <chiko_fill.h>
+#include <chrono>
+#include <string.h>
+
+#define BENCH_SHAPES            20000  // Random shapes of each kind
+#define BENCH_EYE_FRAMES        20000
+#define BENCH_FRAME_SIZE        1024   // 128 x 64 pixels, 1 bit each
+
+// Regression limits
+#define BENCH_MIN_SPEEDUP       0.8    // Horizontal lines set one bit per byte and gain little
+#define BENCH_MIN_EYE_SPEEDUP   2.0
+
+enum BENCH_SHAPE {BENCH_HLINE, BENCH_VLINE, BENCH_BOX, BENCH_RBOX};
+
+struct BenchShape {
+  int x, y, w, h, r;
+  uint8_t color;
+};
+
+static u8g2_t benchU8g2;
+static uint8_t stockFrame[BENCH_FRAME_SIZE];
+static uint8_t fillFrame[BENCH_FRAME_SIZE];
+static BenchShape shapes[BENCH_SHAPES];
+static int benchFailures = 0;
+
+static void check(const char *name, float value, float limit) {
+  bool pass = value <= limit;
+  Serial.printf("  %-40s %8.2f <= %8.2f  %s\n", name, value, limit, pass ? "PASS" : "FAIL");
+  if (!pass) {
+    benchFailures++;
+  }
+}
+
+static void checkAtLeast(const char *name, float value, float limit) {
+  bool pass = value >= limit;
+  Serial.printf("  %-40s %8.2f >= %8.2f  %s\n", name, value, limit, pass ? "PASS" : "FAIL");
+  if (!pass) {
+    benchFailures++;
+  }
+}
+
+static uint64_t nowNs(void) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*
+    Draw into one of the two frames, with the stock or the fill path
+    */
+static void useFrame(bool fill) {
+  benchU8g2.tile_buf_ptr = fill ? fillFrame : stockFrame;
+  benchU8g2.ll_hvline = fill ? fill_hvline : u8g2_ll_hvline_vertical_top_lsb;
+}
+
+static void drawShape(BENCH_SHAPE kind, const BenchShape &shape, bool fill) {
+  u8g2_SetDrawColor(&benchU8g2, shape.color);
+  switch (kind) {
+    case BENCH_HLINE:
+      u8g2_DrawHLine(&benchU8g2, shape.x, shape.y, shape.w);
+      break;
+    case BENCH_VLINE:
+      u8g2_DrawVLine(&benchU8g2, shape.x, shape.y, shape.h);
+      break;
+    case BENCH_BOX:
+      if (fill) {
+        fill_box(&benchU8g2, shape.x, shape.y, shape.w, shape.h);
+      } else {
+        u8g2_DrawBox(&benchU8g2, shape.x, shape.y, shape.w, shape.h);
+      }
+      break;
+    case BENCH_RBOX:
+      if (fill) {
+        fill_roundBox(&benchU8g2, shape.x, shape.y, shape.w, shape.h, shape.r);
+      } else {
+        u8g2_DrawRBox(&benchU8g2, shape.x, shape.y, shape.w, shape.h, shape.r);
+      }
+      break;
+  }
+}
+
+/*
+    Random shapes around the display, some cross its edges. Rounded boxes are
+    drawn in colors 0 and 1, and a few in 2, which U8g2 draws.
+    */
+static void makeShapes(BENCH_SHAPE kind) {
+  randomSeed(kind + 1);
+  for (int i = 0; i < BENCH_SHAPES; i++) {
+    BenchShape &shape = shapes[i];
+    shape.x = random(-16, 128);
+    shape.y = random(-16, 64);
+    shape.w = random(1, 96);
+    shape.h = random(1, 48);
+    shape.r = 0;
+    shape.color = random(0, 3);
+    if (kind == BENCH_RBOX) {
+      // U8g2 needs w and h of at least 2 * r + 2, as display_fillRoundRect() ensures
+      shape.w = random(2, 96);
+      shape.h = random(2, 48);
+      shape.r = random(0, (min(shape.w, shape.h) - 2) / 2 + 1);
+      shape.color = random(0, 8) == 0 ? 2 : random(0, 2);
+    }
+  }
+}
+
+/*
+    Both paths draw every shape, the frames are compared after each one
+    */
+static void benchShapes(const char *name, BENCH_SHAPE kind) {
+  makeShapes(kind);
+  memset(stockFrame, 0x5A, sizeof(stockFrame));
+  memset(fillFrame, 0x5A, sizeof(fillFrame));
+  int mismatches = 0;
+  for (int i = 0; i < BENCH_SHAPES; i++) {
+    useFrame(false);
+    drawShape(kind, shapes[i], false);
+    useFrame(true);
+    drawShape(kind, shapes[i], true);
+    if (memcmp(stockFrame, fillFrame, sizeof(stockFrame)) != 0) {
+      mismatches++;
+      memcpy(fillFrame, stockFrame, sizeof(fillFrame));
+    }
+  }
+
+  // Timed runs, the pixel count is the unclipped area of the shapes
+  double pixels = 0;
+  for (int i = 0; i < BENCH_SHAPES; i++) {
+    const BenchShape &shape = shapes[i];
+    pixels += kind == BENCH_HLINE ? shape.w : kind == BENCH_VLINE ? shape.h : (double)shape.w * shape.h;
+  }
+  uint64_t elapsedNs[2];
+  for (int fill = 0; fill < 2; fill++) {
+    useFrame(fill);
+    uint64_t start = nowNs();
+    for (int i = 0; i < BENCH_SHAPES; i++) {
+      drawShape(kind, shapes[i], fill);
+    }
+    elapsedNs[fill] = nowNs() - start;
+  }
+  float stockRate = pixels / (elapsedNs[0] / 1e9) / 1e6;
+  float fillRate = pixels / (elapsedNs[1] / 1e9) / 1e6;
+  Serial.printf("%-16s U8g2 %9.1f Mpx/S  fill %9.1f Mpx/S  speedup %6.2f\n",
+                name, stockRate, fillRate, fillRate / stockRate);
+  check("Mismatches", mismatches, 0);
+  checkAtLeast("Speedup", fillRate / stockRate, BENCH_MIN_SPEEDUP);
+}
+
+/*
+    Frame of the face: clear, then the two eyes as display_fillRoundRect() draws them
+    */
+static void benchEyes(void) {
+  const BenchShape eyes[2] = {{10, 12, 40, 40, 10, 1}, {78, 12, 40, 40, 10, 1}};
+  uint64_t elapsedNs[2];
+  for (int fill = 0; fill < 2; fill++) {
+    useFrame(fill);
+    uint64_t start = nowNs();
+    for (int frame = 0; frame < BENCH_EYE_FRAMES; frame++) {
+      u8g2_ClearBuffer(&benchU8g2);
+      drawShape(BENCH_RBOX, eyes[0], fill);
+      drawShape(BENCH_RBOX, eyes[1], fill);
+    }
+    elapsedNs[fill] = nowNs() - start;
+  }
+  float stockUs = elapsedNs[0] / 1e3 / BENCH_EYE_FRAMES;
+  float fillUs = elapsedNs[1] / 1e3 / BENCH_EYE_FRAMES;
+  Serial.printf("%-16s U8g2 %9.2f uS/frame fill %9.2f uS/frame speedup %6.2f\n",
+                "Eyes", stockUs, fillUs, stockUs / fillUs);
+  check("Mismatches", memcmp(stockFrame, fillFrame, sizeof(stockFrame)) != 0, 0);
+  checkAtLeast("Speedup", stockUs / fillUs, BENCH_MIN_EYE_SPEEDUP);
+}
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println("Chiko face fill benchmark");
+  u8g2_Setup_ssd1309_128x64_noname2_f(&benchU8g2, U8G2_R0, u8x8_byte_empty, u8x8_dummy_cb);
+  Serial.printf("Vertical top lsb buffer: %s\n\n", fill_isVerticalTopLsb(&benchU8g2) ? "yes" : "no");
+
+  benchShapes("Horizontal lines", BENCH_HLINE);
+  benchShapes("Vertical lines", BENCH_VLINE);
+  benchShapes("Boxes", BENCH_BOX);
+  benchShapes("Rounded boxes", BENCH_RBOX);
+  benchEyes();
+
+  Serial.printf("\n%s (%d failures)\n", benchFailures == 0 ? "PASS" : "FAIL", benchFailures);
+  exit(benchFailures == 0 ? 0 : 1);
+}
+
+void loop() {
+}
@@ -0,0 +1,197 @@
+/**
+ * @file bench_face_render.cpp
+ * @brief Headless render harness of the ChikoBot face (env:Benchmark_face_render).
+ *
+ * Runs the real chiko_face against a captured SSD1309 (see capture_display.h). The
+ * face is initialized without its task and the harness calls face_update() by hand,
+ * one EYES_FRAME_MS step of a simulated clock at a time, so every run draws exactly
+ * the same frames.
+ *
+ * For each expression:
+ * 1. **Frames:** every frame that was sent is written as a PBM image to
+ *    face_frames/<expression>_<frame>.pbm (FACE_FRAMES_DIR overrides the directory).
+ *    With FACE_GOLDEN_DIR set, each image is compared with the file of the same name
+ *    there, e.g. the images of a run before a rendering change.
+ * 2. **Frames per second:** CPU time of face_update() for the frames it drew, drawing
+ *    and sending included.
+ * 3. **SPI bytes per frame:** commands and data sent per frame, and the frame rate the
+ *    bus clock allows at that size.
+ * 4. **Checksum:** of all images of the expression, to compare runs at a glance.
+ *
+ * The image the display RAM holds must match the frame chiko_face drew after every
+ * frame. The program exits with a non-zero status if a figure exceeds its limit:
+ *   pio run -e Benchmark_face_render -t exec
+ */
+
+#include <Arduino.h>
+#include <chiko_face.h>
+#include <chrono>
+#include <string>
+#include <sys/stat.h>
+#include "capture_display.h"
+
+#define BENCH_START_MS           1000
+#define BENCH_MAX_FRAMES         400    // Frames of one expression, longer ones are cut
+#define BENCH_FRAME_SIZE         1024
+
+// Regression limits
+#define BENCH_MAX_FRAME_BYTES    1048   // A full frame, 8 tile rows of 128 bytes and 3 commands
+#define BENCH_MAX_RENDER_US      200    // Mean CPU time of a frame on the host
+
+// The display object of chiko_face
+extern U8G2_SSD1309_128X64_NONAME2_F_4W_HW_SPI u8g2;
+
+struct BenchExpression {
+  const char *name;
+  void (*play)(void);
+};
+
+static void playBlink(void) { eyes_blink(12); }
+static void playReset(void) { eyes_reset(true); }
+static void playSaccade(void) { eyes_saccade(1, -1); eyes_saccade(-1, 1); }
+static void playPrint(void) { facePrint("Hello, I am Chiko.\nBattery 87%"); }
+static void playPrintMiddle(void) { facePrintMiddle(42); }
+
+static const BenchExpression expressions[] = {
+  {"wakeup", eyes_wakeup},
+  {"blink", playBlink},
+  {"saccade", playSaccade},
+  {"move_right_big", eyes_move_right_big},
+  {"move_left_big", eyes_move_left_big},
+  {"happy", eyes_happy},
+  {"sleep", eyes_sleep},
+  {"reset", playReset},
+  {"print", playPrint},
+  {"print_middle", playPrintMiddle},
+};
+
+static std::string framesDir = "face_frames";
+static const char *goldenDir = NULL;
+static uint32_t benchClockMs = BENCH_START_MS;
+static int benchFailures = 0;
+
+static void check(const char *name, float value, float limit) {
+  bool pass = value <= limit;
+  Serial.printf("  %-40s %8.2f <= %8.2f  %s\n", name, value, limit, pass ? "PASS" : "FAIL");
+  if (!pass) {
+    benchFailures++;
+  }
+}
+
+static uint64_t nowNs(void) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static uint32_t fnv1a(uint32_t hash, const uint8_t *data, size_t size) {
+  for (size_t i = 0; i < size; i++) {
+    hash = (hash ^ data[i]) * 16777619u;
+  }
+  return hash;
+}
+
+/*
+    Compare two files byte by byte, a missing file never matches
+    */
+static bool sameFile(const char *a, const char *b) {
+  FILE *fa = fopen(a, "rb");
+  FILE *fb = fopen(b, "rb");
+  bool same = fa != NULL && fb != NULL;
+  while (same) {
+    int ca = fgetc(fa);
+    int cb = fgetc(fb);
+    same = ca == cb;
+    if (ca == EOF || cb == EOF) {
+      break;
+    }
+  }
+  if (fa != NULL) fclose(fa);
+  if (fb != NULL) fclose(fb);
+  return same;
+}
+
+/*
+    Play one expression to its end and capture every frame sent
+    */
+static void benchExpression(const BenchExpression &expression) {
+  expression.play();
+  int frames = 0;
+  int wrongFrames = 0;
+  int goldenMismatches = 0;
+  uint64_t renderNs = 0;
+  uint32_t bytes = 0;
+  uint32_t maxBytes = 0;
+  uint32_t checksum = 2166136261u;
+  do {
+    captureResetCounters();
+    uint64_t start = nowNs();
+    bool drawn = face_update(benchClockMs);
+    uint64_t elapsed = nowNs() - start;
+    benchClockMs += EYES_FRAME_MS;
+    if (!drawn) {
+      continue;
+    }
+    CaptureCounters counters = captureGetCounters();
+    renderNs += elapsed;
+    bytes += counters.bytes;
+    maxBytes = max(maxBytes, counters.bytes);
+
+    // The back buffer starts as a copy of the frame just sent
+    uint8_t frame[BENCH_FRAME_SIZE];
+    captureGetFrame(frame);
+    if (memcmp(frame, u8g2.getBufferPtr(), BENCH_FRAME_SIZE) != 0) {
+      wrongFrames++;
+    }
+    checksum = fnv1a(checksum, frame, BENCH_FRAME_SIZE);
+
+    char name[64];
+    snprintf(name, sizeof(name), "/%s_%03d.pbm", expression.name, frames);
+    std::string path = framesDir + name;
+    FILE *file = fopen(path.c_str(), "w");
+    if (file != NULL) {
+      captureWritePbm(file);
+      fclose(file);
+    }
+    if (goldenDir != NULL && !sameFile(path.c_str(), (std::string(goldenDir) + name).c_str())) {
+      goldenMismatches++;
+    }
+    frames++;
+  } while (eyes_isAnimating() && frames < BENCH_MAX_FRAMES);
+
+  float renderUs = frames > 0 ? renderNs / 1e3 / frames : 0;
+  float bytesPerFrame = frames > 0 ? bytes / (float)frames : 0;
+  float busFps = bytesPerFrame > 0 ? captureGetClockHz() / 8.0 / bytesPerFrame : 0;
+  Serial.printf("%-16s %4d frames %8.2f uS/frame %9.0f fps %7.1f B/frame (max %4u) bus %6.0f fps  %08x\n",
+                expression.name, frames, renderUs, renderUs > 0 ? 1e6 / renderUs : 0,
+                bytesPerFrame, (unsigned)maxBytes, busFps, (unsigned)checksum);
+  check("Frames not shown as drawn", wrongFrames, 0);
+  check("Max SPI bytes per frame", maxBytes, BENCH_MAX_FRAME_BYTES);
+  check("Mean render time [uS]", renderUs, BENCH_MAX_RENDER_US);
+  if (goldenDir != NULL) {
+    check("Frames different from golden", goldenMismatches, 0);
+  }
+}
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println("Chiko face render benchmark");
+  if (getenv("FACE_FRAMES_DIR") != NULL) {
+    framesDir = getenv("FACE_FRAMES_DIR");
+  }
+  goldenDir = getenv("FACE_GOLDEN_DIR");
+  mkdir(framesDir.c_str(), 0755);
+
+  initialize_face(false);
+  Serial.printf("SPI clock %u Hz, frames in %s/%s%s\n\n", (unsigned)captureGetClockHz(), framesDir.c_str(),
+                goldenDir != NULL ? ", golden frames in " : "", goldenDir != NULL ? goldenDir : "");
+
+  for (const BenchExpression &expression : expressions) {
+    benchExpression(expression);
+  }
+
+  Serial.printf("\n%s (%d failures)\n", benchFailures == 0 ? "PASS" : "FAIL", benchFailures);
+  exit(benchFailures == 0 ? 0 : 1);
+}
+
+void loop() {
+}
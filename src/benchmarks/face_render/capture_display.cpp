@@ -0,0 +1,140 @@
+#include "capture_display.h"
+#include <U8x8lib.h>
+#include <string.h>
+
+// SSD1309 display RAM, written in page addressing mode (the mode the U8g2 driver selects)
+static uint8_t captureRam[CAPTURE_RAM_PAGES][CAPTURE_RAM_COLUMNS];
+static uint8_t capturePage = 0;
+static uint8_t captureColumn = 0;
+static uint8_t captureXOffset = 0;
+static uint32_t captureClockHz = 0;
+
+static bool captureData = false;      // D/C line, high for display RAM writes
+static uint8_t captureArgs = 0;       // Arguments of the last command still to come
+static CaptureCounters captureCounters = {0, 0, 0};
+
+/*
+    Arguments of the SSD1309 commands U8g2 sends, the scroll setup commands are never sent
+    */
+static uint8_t getArgCount(uint8_t command) {
+  switch (command) {
+    case 0x21:  // Column address
+    case 0x22:  // Page address
+      return 2;
+    case 0x20:  // Addressing mode
+    case 0x81:  // Contrast
+    case 0x8D:  // Charge pump
+    case 0xA8:  // Multiplex ratio
+    case 0xD3:  // Display offset
+    case 0xD5:  // Clock divide
+    case 0xD9:  // Pre-charge period
+    case 0xDA:  // COM pins
+    case 0xDB:  // VCOMH level
+    case 0xFD:  // Command lock
+      return 1;
+    default:
+      return 0;
+  }
+}
+
+static void runCommand(uint8_t command) {
+  if (captureArgs > 0) {
+    captureArgs--;
+    return;
+  }
+  if (command <= 0x0F) {
+    captureColumn = (captureColumn & 0xF0) | command;
+  } else if (command <= 0x1F) {
+    captureColumn = (captureColumn & 0x0F) | ((command & 0x0F) << 4);
+  } else if (command >= 0xB0 && command <= 0xB7) {
+    capturePage = command & 0x07;
+  } else {
+    captureArgs = getArgCount(command);
+  }
+}
+
+static void writeData(uint8_t data) {
+  if (captureColumn < CAPTURE_RAM_COLUMNS) {
+    captureRam[capturePage][captureColumn] = data;
+  }
+  // In page addressing mode the column wraps within the page
+  captureColumn = (captureColumn + 1) % CAPTURE_RAM_COLUMNS;
+}
+
+/*
+    Byte callback of the U8G2_..._4W_HW_SPI classes, in place of the SPI bus
+    */
+extern "C" uint8_t u8x8_byte_arduino_hw_spi(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr) {
+  switch (msg) {
+    case U8X8_MSG_BYTE_INIT:
+      captureClockHz = u8x8->display_info->sck_clock_hz;
+      captureXOffset = u8x8->x_offset;
+      break;
+    case U8X8_MSG_BYTE_SET_DC:
+      captureData = arg_int != 0;
+      break;
+    case U8X8_MSG_BYTE_START_TRANSFER:
+      captureCounters.transfers++;
+      // The x offset is only known once the driver set the flip mode
+      captureXOffset = u8x8->x_offset;
+      break;
+    case U8X8_MSG_BYTE_SEND: {
+      const uint8_t *data = (const uint8_t *)arg_ptr;
+      captureCounters.bytes += arg_int;
+      for (int i = 0; i < arg_int; i++) {
+        if (captureData) {
+          captureCounters.dataBytes++;
+          writeData(data[i]);
+        } else {
+          runCommand(data[i]);
+        }
+      }
+      break;
+    }
+    case U8X8_MSG_BYTE_END_TRANSFER:
+      break;
+    default:
+      return 0;
+  }
+  return 1;
+}
+
+/*
+    GPIO and delay callback, nothing to drive and no reason to wait on the host
+    */
+extern "C" uint8_t u8x8_gpio_and_delay_arduino(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr) {
+  return 1;
+}
+
+CaptureCounters captureGetCounters(void) {
+  return captureCounters;
+}
+
+void captureResetCounters(void) {
+  memset(&captureCounters, 0, sizeof(captureCounters));
+}
+
+uint32_t captureGetClockHz(void) {
+  return captureClockHz;
+}
+
+void captureGetFrame(uint8_t *frame) {
+  for (int page = 0; page < CAPTURE_RAM_PAGES; page++) {
+    memcpy(frame + page * 128, &captureRam[page][captureXOffset], 128);
+  }
+}
+
+static FILE *pbmFile = NULL;
+
+static void writePbmText(const char *s) {
+  fputs(s, pbmFile);
+}
+
+void captureWritePbm(FILE *file) {
+  uint8_t frame[CAPTURE_RAM_PAGES * 128];
+  captureGetFrame(frame);
+  pbmFile = file;
+  u8x8_capture_write_pbm_pre(16, CAPTURE_RAM_PAGES, writePbmText);
+  u8x8_capture_write_pbm_buffer(frame, 16, CAPTURE_RAM_PAGES, u8x8_capture_get_pixel_1, writePbmText);
+  pbmFile = NULL;
+}
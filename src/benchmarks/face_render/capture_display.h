@@ -0,0 +1,58 @@
+/**
+ * @file capture_display.h
+ * @brief Headless SSD1309 for host builds of the face.
+ *
+ * U8g2 only compiles its Arduino byte and GPIO callbacks with ARDUINO. On the host
+ * the display class of chiko_face gets the callbacks in capture_display.cpp instead:
+ * they count the bytes that would go out on the SPI bus and run the commands and
+ * data through a model of the SSD1309 display RAM, so the captured image is what
+ * the panel would show, tile updates included.
+ */
+
+#ifndef __CAPTURE_DISPLAY__
+#define __CAPTURE_DISPLAY__
+
+#include <stdint.h>
+#include <stdio.h>
+
+#define CAPTURE_RAM_COLUMNS   132   // Columns of the controller RAM, the panel shows 128 from the x offset
+#define CAPTURE_RAM_PAGES     8
+
+/**
+ * @struct CaptureCounters
+ * @brief Traffic on the display bus since the last captureResetCounters().
+ */
+struct CaptureCounters {
+  uint32_t bytes;       // Commands and data
+  uint32_t dataBytes;   // Display RAM writes
+  uint32_t transfers;   // Chip select cycles
+};
+
+/**
+ * @brief Get the bus traffic counters.
+ */
+CaptureCounters captureGetCounters(void);
+
+/**
+ * @brief Zero the bus traffic counters.
+ */
+void captureResetCounters(void);
+
+/**
+ * @brief Get the SPI clock U8g2 configured for the display.
+ * @return Clock in Hz, 0 before the display was initialized.
+ */
+uint32_t captureGetClockHz(void);
+
+/**
+ * @brief Copy the 128x64 image the panel shows, in the U8g2 buffer layout (8 pixel high columns).
+ * @param frame 1024 bytes.
+ */
+void captureGetFrame(uint8_t *frame);
+
+/**
+ * @brief Write the image the panel shows as a plain PBM.
+ */
+void captureWritePbm(FILE *file);
+
+#endif
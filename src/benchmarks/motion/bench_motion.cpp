@@ -0,0 +1,304 @@
+/**
+ * @file bench_motion.cpp
+ * @brief Host benchmark of the ChikoBot motion stack (env:Benchmark_motion).
+ *
+ * Runs the real joint scheduler, motion player and walking gait against the
+ * chiko_native shim, where every servo write is recorded with its time stamp.
+ *
+ * Reported figures:
+ * 1. **Tick cost:** CPU time of one jointSchedulerTick() over all joints, with
+ *    new moves planned regularly. The scheduler timer is stopped and the tick
+ *    is called by hand.
+ * 2. **Setpoint to PWM latency:** time from a commit to the first servo pulse
+ *    that reflects it. Commits are spread over the update period, the mean is
+ *    expected around half a period and is gated. The maximum depends on how the
+ *    host schedules the threads and is only reported.
+ * 3. **Input to PWM latency:** time from a simulated controller notification,
+ *    committed by the scheduler tick hook like chiko_teleop does, to the servo
+ *    write, as reported by the latency callback of the scheduler. The report
+ *    must match the PWM log, and like the setpoint latency only its mean is gated.
+ * 4. **Gait cycle time:** duration of each stride of the walking gait compared
+ *    to the sum of its keyframe durations, and of the whole walk.
+ *
+ * The program exits with a non-zero status if a figure exceeds its limit, so it
+ * can gate changes to the motion code on an ordinary Linux box:
+ *   pio run -e Benchmark_motion -t exec
+ */
+
+#include <Arduino.h>
+#include <chiko_joint.h>
+#include <chiko_motion.h>
+#include <chiko_native.h>
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include "../../examples/walk/walk_gait.h"
+
+#define BENCH_TICK_SAMPLES          20000
+#define BENCH_TICK_REPLAN_PERIOD    25    // Ticks between two planned moves
+#define BENCH_LATENCY_SAMPLES       100
+#define BENCH_GAIT_LOOPS            4
+
+// Regression limits
+#define BENCH_MAX_TICK_MEAN_US      50    // Mean cost of a tick on the host
+#define BENCH_MAX_LATENCY_SLACK_MS  5     // Allowed mean latency beyond half an update period
+#define BENCH_MAX_CYCLE_ERROR_MS    5     // Allowed stride time error
+#define BENCH_MAX_REPORT_ERROR_MS   1     // Allowed difference of the reported latency from the PWM log
+
+Joint LeftLeg, RightLeg, LeftFoot, RightFoot;
+motionPlayer benchPlayer;
+
+static int benchFailures = 0;
+
+static std::atomic<uint64_t> latencyCommitUs(0);
+static std::atomic<uint64_t> latencyPwmUs(0);
+static float latencyPulseUs = 0;
+static std::atomic<uint32_t> inputPendingUs(0);   // Simulated notification not committed yet
+static std::atomic<uint32_t> inputReportedUs(0);  // Latency reported by the scheduler
+static float inputAngle = 0;
+
+struct BenchStats {
+  float mean;
+  float p50;
+  float p99;
+  float max;
+};
+
+static BenchStats getStats(std::vector<float> samples) {
+  BenchStats stats = {0, 0, 0, 0};
+  if (samples.empty()) {
+    return stats;
+  }
+  std::sort(samples.begin(), samples.end());
+  for (float sample : samples) {
+    stats.mean += sample;
+  }
+  stats.mean /= samples.size();
+  stats.p50 = samples[samples.size() / 2];
+  stats.p99 = samples[(samples.size() * 99) / 100];
+  stats.max = samples.back();
+  return stats;
+}
+
+static void printStats(const char *name, const char *unit, const BenchStats &stats) {
+  Serial.printf("%-28s mean %8.2f  p50 %8.2f  p99 %8.2f  max %8.2f %s\n",
+                name, stats.mean, stats.p50, stats.p99, stats.max, unit);
+}
+
+static void check(const char *name, float value, float limit) {
+  bool pass = value <= limit;
+  Serial.printf("  %-40s %8.2f <= %8.2f  %s\n", name, value, limit, pass ? "PASS" : "FAIL");
+  if (!pass) {
+    benchFailures++;
+  }
+}
+
+/*
+    Tick cost, the scheduler is stopped and ticked by hand
+    */
+static void benchTickCost(void) {
+  Joint *joints[] = {&LeftFoot, &LeftLeg, &RightFoot, &RightLeg};
+  const TRAJECTORY_PROFILE profiles[] = {CONSTANT_SPEED, TRAPEZOIDAL, S_CURVE, MINIMUM_JERK};
+  std::vector<float> samples;
+  samples.reserve(BENCH_TICK_SAMPLES);
+
+  stopJointScheduler();
+  delay(2 * getJointUpdateRate());
+  for (int i = 0; i < BENCH_TICK_SAMPLES; i++) {
+    if (i % BENCH_TICK_REPLAN_PERIOD == 0) {
+      JointTarget targets[4];
+      for (int j = 0; j < 4; j++) {
+        joints[j]->setProfile(profiles[(i / BENCH_TICK_REPLAN_PERIOD + j) % 4]);
+        targets[j] = {joints[j], (float)random(-60, 60), 100};
+      }
+      commitTimedPose(targets, 4, 2 * BENCH_TICK_REPLAN_PERIOD * getJointUpdateRate());
+    }
+    auto start = std::chrono::steady_clock::now();
+    jointSchedulerTick();
+    auto end = std::chrono::steady_clock::now();
+    samples.push_back(std::chrono::duration<float, std::micro>(end - start).count());
+  }
+  for (int j = 0; j < 4; j++) {
+    joints[j]->setProfile(DEFAULT_JOINT_PROFILE);
+  }
+  startJointScheduler();
+  commitPose({{&LeftFoot, 0, 100}, {&LeftLeg, 0, 100}, {&RightFoot, 0, 100}, {&RightLeg, 0, 100}});
+  waitTillAllJointsAvailable();
+
+  BenchStats stats = getStats(samples);
+  printStats("Tick cost (4 joints)", "uS", stats);
+  check("Mean tick cost [uS]", stats.mean, BENCH_MAX_TICK_MEAN_US);
+}
+
+static void latencyHook(const PwmWrite &write) {
+  if (write.pin == RIGHTFOOT_PIN && latencyCommitUs.load() != 0 && latencyPwmUs.load() == 0 &&
+      write.pulseUs != latencyPulseUs) {
+    latencyPwmUs = write.timeUs;
+  }
+}
+
+/*
+    Setpoint to PWM latency, the scheduler runs on its timer
+    */
+static void benchLatency(void) {
+  std::vector<float> samples;
+  setPwmWriteHook(latencyHook);
+  for (int i = 0; i < BENCH_LATENCY_SAMPLES; i++) {
+    // Spread the commits over the update period
+    delayMicroseconds(random(0, 1000 * getJointUpdateRate()));
+    latencyPwmUs = 0;
+    latencyPulseUs = getPwmPulseWidth(RIGHTFOOT_PIN);
+    latencyCommitUs = nativeTimeUs();
+    RightFoot.moveTo((i % 2) ? -30 : 30, 1);
+    waitTillJointsAvailable(getJointBit(&RightFoot));
+    if (latencyPwmUs.load() != 0) {
+      samples.push_back((latencyPwmUs.load() - latencyCommitUs.load()) / (float)1000);
+    }
+    latencyCommitUs = 0;
+  }
+  setPwmWriteHook(NULL);
+  RightFoot.moveTo(0, 1);
+  waitTillAllJointsAvailable();
+
+  BenchStats stats = getStats(samples);
+  printStats("Setpoint to PWM latency", "mS", stats);
+  check("Missed commits", BENCH_LATENCY_SAMPLES - (int)samples.size(), 0);
+  check("Mean latency [mS]", stats.mean, getJointUpdateRate() / (float)2 + BENCH_MAX_LATENCY_SLACK_MS);
+}
+
+static void inputTickHook(void *param) {
+  uint32_t inputUs = inputPendingUs.exchange(0);
+  if (inputUs != 0) {
+    JointTarget target = {&RightFoot, inputAngle, 100};
+    commitInputPose(&target, 1, inputUs);
+  }
+}
+
+static void inputLatencyCallback(void *param, uint32_t latencyUs) {
+  inputReportedUs = latencyUs;
+}
+
+static const JointTickHook inputHook = {inputTickHook, NULL};
+static const JointLatencyCallback inputCallback = {inputLatencyCallback, NULL};
+
+/*
+    Input to PWM latency, inputs are committed by the tick hook and timed by the scheduler
+    */
+static void benchInputLatency(void) {
+  std::vector<float> samples;
+  float reportError = 0;
+  setJointTickHook(&inputHook);
+  setJointLatencyCallback(&inputCallback);
+  setPwmWriteHook(latencyHook);
+  for (int i = 0; i < BENCH_LATENCY_SAMPLES; i++) {
+    delayMicroseconds(random(0, 1000 * getJointUpdateRate()));
+    latencyPwmUs = 0;
+    latencyPulseUs = getPwmPulseWidth(RIGHTFOOT_PIN);
+    inputReportedUs = 0;
+    inputAngle = (i % 2) ? -30 : 30;
+    latencyCommitUs = nativeTimeUs();
+    inputPendingUs = latencyCommitUs.load();
+    for (int wait = 0; inputReportedUs.load() == 0 && wait < 10 * (int)getJointUpdateRate(); wait++) {
+      delay(1);
+    }
+    if (inputReportedUs.load() != 0 && latencyPwmUs.load() != 0) {
+      float reportedMs = inputReportedUs.load() / (float)1000;
+      samples.push_back(reportedMs);
+      reportError = max(reportError, fabsf(reportedMs - (latencyPwmUs.load() - latencyCommitUs.load()) / (float)1000));
+    }
+    latencyCommitUs = 0;
+  }
+  setPwmWriteHook(NULL);
+  setJointLatencyCallback(NULL);
+  setJointTickHook(NULL);
+  RightFoot.moveTo(0, 1);
+  waitTillAllJointsAvailable();
+
+  BenchStats stats = getStats(samples);
+  printStats("Input to PWM latency", "mS", stats);
+  check("Missed inputs", BENCH_LATENCY_SAMPLES - (int)samples.size(), 0);
+  check("Mean reported latency [mS]", stats.mean, getJointUpdateRate() / (float)2 + BENCH_MAX_LATENCY_SLACK_MS);
+  check("Max report error [mS]", reportError, BENCH_MAX_REPORT_ERROR_MS);
+}
+
+static uint32_t getClipDuration(const MotionClip &clip) {
+  uint32_t duration = 0;
+  for (uint16_t i = 0; i < clip.count; i++) {
+    duration += clip.keyframes[i].durationMs;
+  }
+  return duration;
+}
+
+/*
+    Gait cycle time, every stride of the walk is timed from the loop counter
+    */
+static void benchGait(void) {
+  std::vector<float> strides;
+  uint32_t strideMs = getClipDuration(walkGait.loop);
+  // action runs its loop routine once more when the count reaches zero
+  uint32_t strideCount = BENCH_GAIT_LOOPS + 1;
+  uint32_t idealMs = getClipDuration(walkGait.enter) + strideCount * strideMs + getClipDuration(walkGait.exit);
+
+  benchPlayer.attach(&LeftFoot, &LeftLeg, &RightFoot, &RightLeg);
+  benchPlayer.load(&walkGait);
+  size_t firstWrite = getPwmWriteCount();
+  uint64_t start = nativeTimeUs();
+  benchPlayer.play(BENCH_GAIT_LOOPS);
+
+  unsigned long long loops = benchPlayer.getLoopsRemaining();
+  uint64_t loopChangeUs = 0;
+  while (benchPlayer.isPlaying()) {
+    unsigned long long remaining = benchPlayer.getLoopsRemaining();
+    if (remaining != loops) {
+      uint64_t now = nativeTimeUs();
+      if (loopChangeUs != 0) {
+        strides.push_back((now - loopChangeUs) / (float)1000);
+      }
+      loopChangeUs = now;
+      loops = remaining;
+    }
+    delayMicroseconds(200);
+  }
+  uint64_t end = nativeTimeUs();
+
+  // The walk starts with the first servo pulse of the gait
+  PwmWrite write;
+  for (size_t i = firstWrite; i < getPwmWriteCount(); i++) {
+    if (getPwmWrite(i, &write) && write.timeUs >= start) {
+      start = write.timeUs;
+      break;
+    }
+  }
+  float totalMs = (end - start) / (float)1000;
+
+  float strideError = 0;
+  for (float stride : strides) {
+    strideError = max(strideError, fabsf(stride - strideMs));
+  }
+
+  BenchStats stats = getStats(strides);
+  printStats("Stride time", "mS", stats);
+  Serial.printf("%-28s %8.2f mS (keyframes %u mS, %u strides)\n", "Walk time", totalMs, (unsigned)idealMs, (unsigned)strideCount);
+  // The counter changes on each of the BENCH_GAIT_LOOPS decrements
+  check("Strides not timed", BENCH_GAIT_LOOPS - 1 - (int)strides.size(), 0);
+  check("Max stride error [mS]", strideError, BENCH_MAX_CYCLE_ERROR_MS);
+  check("Walk overrun [mS]", fabsf(totalMs - idealMs), getJointUpdateRate() + BENCH_MAX_CYCLE_ERROR_MS);
+}
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println("Chiko motion benchmark");
+  initialize_joints(&LeftFoot, &LeftLeg, &RightFoot, &RightLeg);
+  Serial.printf("Joint update period %u mS\n\n", (unsigned)getJointUpdateRate());
+
+  benchTickCost();
+  benchLatency();
+  benchInputLatency();
+  benchGait();
+
+  Serial.printf("\n%s (%d failures)\n", benchFailures == 0 ? "PASS" : "FAIL", benchFailures);
+  exit(benchFailures == 0 ? 0 : 1);
+}
+
+void loop() {
+}
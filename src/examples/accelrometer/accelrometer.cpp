@@ -2,20 +2,45 @@
 #include <chiko_BMA250.h>
 
 BMA250 accelrometer;
+BMA250Reader accelReader;
 
 void setup() {
   Serial.begin(115200);
   Serial.println("Starting Chiko BMA250 Test");
   accelrometer.initialize();
+  // The sampling task reads the sensor at its output data rate, this example is one reader of the stream
+  accelrometer.startSampling();
+  accelReader = accelrometer.createReader();
 }   
 
 void loop() {
   // put your main code here, to run repeatedly:
-  float x = accelrometer.readXaxis();
-  float y = accelrometer.readYaxis();
-  float z = accelrometer.readZaxis();
+  // Average the samples still in the ring. It holds the last BMA250_SAMPLE_RING_SIZE samples
+  // (about 256 mS at 250 Hz), the older ones since the last print are skipped and not averaged.
+  BMA250Sample sample;
+  int32_t sum[3] = {0, 0, 0};
+  int count = 0;
+  while (accelReader.read(&sample)) {
+    sum[BMA250_AXIS_X] += sample.axis[BMA250_AXIS_X];
+    sum[BMA250_AXIS_Y] += sample.axis[BMA250_AXIS_Y];
+    sum[BMA250_AXIS_Z] += sample.axis[BMA250_AXIS_Z];
+    count++;
+  }
+  if (count == 0) {
+    delay(1000);
+    return;
+  }
+  int16_t average[3];
+  for (int i = 0; i < 3; i++) {
+    average[i] = sum[i] / count;
+  }
+  float x = average[BMA250_AXIS_X] / (float)BMA250_LSB_PER_G;
+  float y = average[BMA250_AXIS_Y] / (float)BMA250_LSB_PER_G;
+  float z = average[BMA250_AXIS_Z] / (float)BMA250_LSB_PER_G;
 
-  Serial.print("Gs: X: ");
+  Serial.print("Samples: ");
+  Serial.print(count);
+  Serial.print("\tGs: X: ");
   Serial.print(x);
   Serial.print(" g, Y: ");
   Serial.print(y);
@@ -23,13 +48,13 @@ void loop() {
   Serial.print(z);
   Serial.print(" g");
     Serial.print("\tAngles: Pitch: ");
-    Serial.print(accelrometer.getPitchAngle());
+    Serial.print(BMA250::getPitchAngle(average));
     Serial.print(" deg, Roll: ");
-    Serial.print(accelrometer.getRollAngle());    
+    Serial.print(BMA250::getRollAngle(average));    
     Serial.print(" deg");
     Serial.print("\tTemp: ");
-    Serial.print(accelrometer.getTemperature());
+    Serial.print(sample.temperature * 0.5 + 23);
     Serial.println(" C");
 
   delay(1000);
-}
\ No newline at end of file
+}
@@ -0,0 +1,64 @@
+#include <Arduino.h>
+#include <BLEGamepadClient.h>
+#include <chiko_joint.h>
+#include <chiko_teleop.h>
+
+// Declare joint objects for the robot's limbs
+Joint LeftLeg, RightLeg, LeftFoot, RightFoot;
+
+BLEController gamepad;
+TeleopController teleop;
+
+// Body lean, a gait parameter: both feet tilt the same way on top of their angle
+void setLean(float lean) {
+  LeftFoot.setTrim(lean);
+  RightFoot.setTrim(lean);
+}
+
+void onConnect(NimBLEAddress address) {
+  Serial.printf("controller connected, address: %s\n", address.toString().c_str());
+}
+
+void onDisconnect(NimBLEAddress address) {
+  // The bindings return to rest at their rate until the controller is back
+  Serial.printf("controller disconnected, address: %s\n", address.toString().c_str());
+}
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println("Chiko teleoperation");
+  initialize_joints(&LeftFoot, &LeftLeg, &RightFoot, &RightLeg);
+  LeftFoot.setToZero();
+  LeftLeg.setToZero();
+  RightFoot.setToZero();
+  RightLeg.setToZero();
+
+  gamepad.onConnect(onConnect);
+  gamepad.onDisconnect(onDisconnect);
+  if (!gamepad.begin()) {
+    Serial.println("Failed to initialize BLE");
+    while (1) {
+      delay(1000);
+    }
+  }
+
+  // The sticks swing the legs, the triggers lift the feet and the right stick
+  // leans the body when pushed up or down
+  teleop.begin(&gamepad);
+  teleop.bindAxis(BLEAxisLeftStickX, &LeftLeg, 60, 0.5);
+  teleop.bindAxis(BLEAxisRightStickX, &RightLeg, 60, 0.5);
+  teleop.bindAxis(BLEAxisLeftTrigger, &LeftFoot, 45);
+  teleop.bindAxis(BLEAxisRightTrigger, &RightFoot, -45);
+  teleop.bindAxis(BLEAxisRightStickY, setLean, 15, 0, 60);
+  teleop.enable();
+  Serial.println("Put the Xbox controller into pairing mode to connect.");
+}
+
+void loop() {
+  // The joints are driven by the joint scheduler, only the latency is printed here
+  TeleopLatency latency = teleop.getLatency();
+  Serial.printf("Notify to PWM latency: last %u uS, mean %u uS, max %u uS, %u of %u over %u uS\n",
+                (unsigned)latency.lastUs, (unsigned)latency.meanUs, (unsigned)latency.maxUs,
+                (unsigned)latency.overBudget, (unsigned)latency.count, (unsigned)TELEOP_LATENCY_BUDGET_US);
+  delay(1000);
+}
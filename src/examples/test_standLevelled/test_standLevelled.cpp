@@ -1,9 +1,14 @@
 #include <Arduino.h>
-#include <chiko_bma250.h>
+#include <chiko_BMA250.h>
+#include <chiko_attitude.h>
+#include <chiko_balance.h>
 #include <chiko_joint.h>
 
 
 BMA250 accelrometer;
+BMA250Reader accelReader;
+AttitudeFilter attitude;
+BalanceController balance;
 // Declare joint objects for the robot's limbs
 Joint LeftLeg, RightLeg, LeftFoot, RightFoot;
 
@@ -13,18 +18,36 @@ void setup() {
   Serial.println("Test Chiko");
   Serial.println("Testing Stand Levelled");
   accelrometer.initialize();
+  accelrometer.startSampling();
+  accelReader = accelrometer.createReader();
+  attitude.begin(&accelrometer);
  initialize_joints(&LeftFoot, &LeftLeg, &RightFoot, &RightLeg);
  LeftFoot.setToZero();
  LeftLeg.setToZero();
     RightFoot.setToZero();
     RightLeg.setToZero();
     delay(2000); // Wait for 2 seconds to ensure everything is initialized
+
+    // The balance task keeps the robot level at 100 Hz, tune the gains here
+    balance.begin(&attitude, &LeftFoot, &RightFoot);
+    balance.setGains(1.0f, 0.05f);
+    balance.enable();
 }
 void loop() {
     // put your main code here, to run repeatedly:
-    float x = accelrometer.readXaxis();
-    float y = accelrometer.readYaxis();
-    float z = accelrometer.readZaxis();
+    // Newest sample of the sampling task, every value below comes from the same sample
+    BMA250Sample latest;
+    if (!accelReader.readLatest(&latest)) {
+        delay(1);
+        return;
+    }
+    const int16_t *sample = latest.axis;
+    float x = sample[BMA250_AXIS_X] / (float)BMA250_LSB_PER_G;
+    float y = sample[BMA250_AXIS_Y] / (float)BMA250_LSB_PER_G;
+    float z = sample[BMA250_AXIS_Z] / (float)BMA250_LSB_PER_G;
+    // Low-pass filtered angles, steadier than the angles of a single sample
+    float pitch, roll;
+    attitude.getAttitude(&pitch, &roll);
 
 
     Serial.print("Gs: X: ");
@@ -35,47 +58,16 @@ void loop() {
     Serial.print(z);
     Serial.print(" g");
       Serial.print("\tAngles: Pitch: ");
-      Serial.print(accelrometer.getPitchAngle());
+      Serial.print(pitch);
       Serial.print(" deg, Roll: ");
-      Serial.print(accelrometer.getRollAngle());    
+      Serial.print(roll);    
+      Serial.print(" deg");
+      Serial.print("\tFeet: ");
+      Serial.print(balance.getOutput());
       Serial.print(" deg");
       Serial.print("\tTemp: ");
-      Serial.print(accelrometer.getTemperature());
+      Serial.print(latest.temperature * 0.5 + 23);
       Serial.println(" C");
 
-    // Simple proportional control to keep the robot level
-    // PI controller for pitch angle
-    static float roll_integral = 0.0f;
-    float roll_setpoint = 0.0f; // Target is level
-    float roll_error = roll_setpoint - accelrometer.getRollAngle();
-    float Kp = 1.0f; // Proportional gain, tune as needed
-    float Ki = 0.05f; // Integral gain, tune as needed
-
-    static float roll_output = 0.0f; // Control output for pitch
-    if (roll_output < 50.0f && roll_output > -50.0f){
-        roll_integral += roll_error * 0.1f; // 0.1s loop time (100ms delay)
-    } 
-    
-     roll_output = Kp * roll_error + Ki * roll_integral;
-
-    if (accelrometer.getRollAngle() > 0) {
-        // Tilted forward
-        LeftFoot.setAngle(roll_output, 30);
-        RightFoot.setAngle(-accelrometer.getRollAngle(), 30);
-    } else if (accelrometer.getRollAngle() < 0) {
-        // Tilted backward
-        // LeftLeg.setAngle(-accelrometer.getPitchAngle(), 30);
-        // RightLeg.setAngle(-accelrometer.getPitchAngle(), 30);
-    } else {
-        // Level
-        LeftFoot.setAngle(0, 30);
-        RightFoot.setAngle(0, 30);
-    }
-    
-
-
-//    LeftFoot.setAngle(accelrometer.getRollAngle(), 30);
-//    RightFoot.setAngle(accelrometer.getRollAngle(), 30);
-
-    delay(100); // Adjust delay as needed for responsiveness
-}
\ No newline at end of file
+    delay(100); // Only the print rate, the balance loop runs in its own task
+}
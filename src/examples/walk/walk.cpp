@@ -18,9 +18,11 @@
  * making the robot interactive and responsive to user input. This decouples the 
  * walking logic from the main loop, enabling future expansion (e.g., more gestures, 
  * remote control).
- * - **Action State Machine:** The `action` object encapsulates the walking routine 
- * as a state machine with enter, loop, and exit routines. This modular approach 
- * allows for easy sequencing and reuse of behaviors.
+ * - **Keyframe Gait:** The gait is a table of poses (see walk_gait.h) played by a
+ * `motionPlayer` on top of an `action`, with enter, loop and exit clips. The player
+ * queues the next pose before the current one finishes, so the steps flow into each
+ * other without stop-and-wait gaps. The tables can be replaced by a gait blob in the
+ * "gait" flash partition to tune the walk without rebuilding.
  * - **Safety and Debugging:** The robot always returns to a neutral pose 
  * when starting or stopping walking, reducing the risk of falls or hardware stress. 
  * Serial output provides real-time feedback for debugging and monitoring.
@@ -28,7 +30,7 @@
  * High-Level Flow:
  * 1. **Initialization:** Joints and accelerometer are initialized. Joint offsets are printed for calibration.
  * 2. **Event Binding:** Double-tap gestures (LEFT/RIGHT) are bound to start/stop walking actions.
- * 3. **Walking Action:** When triggered, the walking action executes a sequence of joint movements to simulate a walking gait, repeating for a set number of iterations.
+ * 3. **Walking Action:** When triggered, the player streams the gait keyframes to the joints, repeating the stride for a set number of iterations.
  * 4. **Exit Routine:** On stop, the robot returns to a safe, neutral pose.
  *
  * Usage:
@@ -41,7 +43,8 @@
 #include <Arduino.h>           // Core Arduino functionality
 #include <chiko_joint.h>       // Custom joint control for ChikoBot
 #include <chiko_BMA250.h>      // BMA250 accelerometer support
-#include <chiko_action.h>      // Predefined actions for ChikoBot
+#include <chiko_motion.h>      // Keyframe motion player
+#include "walk_gait.h"         // Walking gait keyframes
 
 
 // Declare joint objects for the robot's limbs.
@@ -51,14 +54,11 @@ Joint LeftLeg, RightLeg, LeftFoot, RightFoot;
 // Accelerometer object for gesture detection (double-tap events)
 BMA250 accelrometer;
 
-// Action object for walking routine.
-// Encapsulates the walking state machine (enter, loop, exit routines)
-action chikoWalkAction;
+// Motion player for the walking gait (enter, loop, exit clips)
+motionPlayer chikoWalkPlayer;
 
-// Forward declarations for walking action routines
-void walkEnterRoutine();   // Called once when walking starts
-void walkLoopRoutine();    // Called repeatedly while walking
-void walkExitRoutine();    // Called once when walking stops
+// Gait loaded from the flash partition, if one was written
+MotionGait partitionGait;
 
 
 /**
@@ -68,7 +68,7 @@ void walkExitRoutine();    // Called once when walking stops
  * Reasoning: Using a lambda (function pointer) allows flexible event binding. The number of loop iterations (5) can be tuned for desired walking distance.
  */
 void WalkStartLambdaFunction(void) {
-  chikoWalkAction.begin(5); // Start walking action with 5 loop iterations
+  chikoWalkPlayer.play(5); // Start walking with 5 strides
 }
 
 /**
@@ -78,7 +78,7 @@ void WalkStartLambdaFunction(void) {
  * Reasoning: Decouples the stop event from the main loop, allowing immediate and safe interruption of walking.
  */
 void WalkEndLambdaFunction(void) {
-  chikoWalkAction.stop(); // Stop the walking action
+  chikoWalkPlayer.stop(); // Finish the stride and play the exit clip
 }
 
 
@@ -114,8 +114,15 @@ void setup() {
   Serial.print(RightFoot.JointOffset);
   Serial.println(" Degrees");
 
-  // Create the walking action and bind routines (state machine)
-  chikoWalkAction.create(walkEnterRoutine, walkLoopRoutine, walkExitRoutine);
+  // Bind the player to the joints and select the gait, a gait written to the
+  // "gait" partition takes precedence over the built-in tables
+  chikoWalkPlayer.attach(&LeftFoot, &LeftLeg, &RightFoot, &RightLeg);
+  if (loadMotionGaitFromPartition(&partitionGait)) {
+    Serial.println("Walking gait loaded from flash partition");
+    chikoWalkPlayer.load(&partitionGait);
+  } else {
+    chikoWalkPlayer.load(&walkGait);
+  }
 
   // Attach double-tap gestures to start/stop walking
   // LEFT: Start walking, RIGHT: Stop walking
@@ -129,133 +136,17 @@ void setup() {
  * @brief Arduino loop function: runs repeatedly after setup.
  * Main control loop for ChikoBot. Add additional logic here if needed.
  *
- * Reasoning: The walking action is event-driven and managed by the action object, so the main loop remains empty unless additional features are added.
+ * Reasoning: The walking action is event-driven and managed by the motion player, so the main loop only reports each new stride.
  */
 void loop() {
   // Main control loop for ChikoBot
-  // The walking action is event-driven; no code needed here unless adding more features.
-}
-
-
-
-/**
- * @brief Walking action entry routine.
- * Sets the robot to a neutral standing pose, then transitions to the initial walking pose.
- * Called once when the walking action begins.
- *
- * Reasoning: Ensures the robot always starts walking from a safe, known configuration. This reduces mechanical stress and improves repeatability.
- *
- * Step-by-step:
- * 1. Set all joints to zero (neutral pose).
- * 2. Move to the first step pose (prepares for walking).
- * 3. Adjust legs for initial gait.
- * 4. Return to neutral before entering the main loop.
- */
-void walkEnterRoutine(void) {
-  // Set all joints to zero (neutral pose)
-  RightFoot.setAngle(0, 50);
-  LeftFoot.setAngle(0, 50);
-  RightLeg.setAngle(0, 50);
-  LeftLeg.setAngle(0, 50);
-  waitTillAllJointsAvailable();
-
-  // Move to first step pose
-  RightFoot.setAngle(40, 100);
-  LeftFoot.setAngle(20, 50);
-  waitTillAllJointsAvailable();
-
-  // Prepare for walking
-  RightFoot.setAngle(20, 100);
-  RightLeg.setAngle(15, 50);
-  LeftLeg.setAngle(15, 50);
-  waitTillAllJointsAvailable();
-
-  // Return to neutral
-  RightFoot.setAngle(0, 50);
-  LeftFoot.setAngle(0, 50);
-  waitTillAllJointsAvailable();
-}
-
-
-/**
- * @brief Walking action loop routine.
- * Repeats the walking gait sequence for each iteration.
- * Called repeatedly while the walking action is active.
- *
- * Reasoning: The gait is broken into discrete steps for clarity and maintainability. Each step is separated by a wait to ensure all joints reach their target before proceeding, preventing mechanical conflicts.
- *
- * Step-by-step:
- * 1. Move feet backward (simulate step back).
- * 2. Shift weight and move legs (simulate weight transfer).
- * 3. Return to neutral (balance).
- * 4. Move feet forward (simulate step forward).
- * 5. Shift weight and move legs (simulate weight transfer).
- * 6. Return to neutral (balance).
- */
-void walkLoopRoutine(void) {
-  Serial.print("Walk Loop Iteration #: ");
-  Serial.println(chikoWalkAction.LoopItrations);
-
-  // Step 1: Move feet backward
-  RightFoot.setAngle(-20, 50);
-  LeftFoot.setAngle(-40, 100);
-  waitTillAllJointsAvailable();
-
-  // Step 2: Shift weight and move legs
-  LeftFoot.setAngle(-20, 100);
-  RightLeg.setAngle(-15, 50);
-  LeftLeg.setAngle(-15, 50);
-  waitTillAllJointsAvailable();
-
-  // Step 3: Return to neutral
-  RightFoot.setAngle(0, 50);
-  LeftFoot.setAngle(0, 50);
-  waitTillAllJointsAvailable();
-
-  // Step 4: Move feet forward
-  RightFoot.setAngle(40, 100);
-  LeftFoot.setAngle(20, 50);
-  waitTillAllJointsAvailable();
-
-  // Step 5: Shift weight and move legs
-  RightFoot.setAngle(20, 100);
-  RightLeg.setAngle(15, 50);
-  LeftLeg.setAngle(15, 50);
-  waitTillAllJointsAvailable();
-
-  // Step 6: Return to neutral
-  RightFoot.setAngle(0, 50);
-  LeftFoot.setAngle(0, 50);
-  waitTillAllJointsAvailable();
-}
-
-
-/**
- * @brief Walking action exit routine.
- * Returns the robot to a safe, neutral pose when walking ends.
- * Called once when the walking action is stopped.
- *
- * Reasoning: Ensures the robot always stops in a safe, balanced configuration, reducing risk of falls or hardware damage.
- *
- * Step-by-step:
- * 1. Move feet backward to stop motion.
- * 2. Return legs to neutral (balance).
- * 3. Set all joints to zero (neutral pose).
- */
-void walkExitRoutine(void) {
-  // Move feet backward to stop
-  RightFoot.setAngle(-20, 50);
-  LeftFoot.setAngle(-40, 100);
-  waitTillAllJointsAvailable();
-
-  // Return legs to neutral
-  LeftFoot.setAngle(-20, 100);
-  RightLeg.setAngle(0, 50);
-  LeftLeg.setAngle(0, 50);
-  waitTillAllJointsAvailable();
-
-  // Set all joints to zero (neutral pose)
-  RightFoot.setAngle(0, 50);
-  LeftFoot.setAngle(0, 50);
-  waitTillAllJointsAvailable();
+  // The walking action is event-driven; the loop prints the iteration count whenever a stride starts.
+  static unsigned long long lastLoopsRemaining = U_LONGLONGMAX;
+  unsigned long long loopsRemaining = chikoWalkPlayer.getLoopsRemaining();
+  if (chikoWalkPlayer.isPlaying() && loopsRemaining != lastLoopsRemaining) {
+    Serial.print("Walk Loop Iteration #: ");
+    Serial.println(loopsRemaining);
+  }
+  lastLoopsRemaining = loopsRemaining;
+  delay(10);
 }
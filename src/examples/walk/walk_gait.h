@@ -0,0 +1,61 @@
+/**
+ * @file walk_gait.h
+ * @brief Keyframes of the ChikoBot walking gait.
+ *
+ * Each row is one pose: joint angles in degrees (left foot, left leg, right foot, right leg),
+ * the time to reach the pose, the velocity profile and the joints it moves. Joints outside
+ * the mask hold their previous angle, the tables spell the held angles out for readability.
+ * The same tables can be exported as a binary blob (see MotionGaitHeader) and written to the
+ * "gait" partition to tune without rebuilding.
+ */
+
+#ifndef __WALK_GAIT__
+#define __WALK_GAIT__
+
+#include <chiko_motion.h>
+
+#define FEET   (MOTION_JOINT_BIT(MOTION_LEFT_FOOT) | MOTION_JOINT_BIT(MOTION_RIGHT_FOOT))
+#define LEGS   (MOTION_JOINT_BIT(MOTION_LEFT_LEG) | MOTION_JOINT_BIT(MOTION_RIGHT_LEG))
+#define LEFT_FOOT   MOTION_JOINT_BIT(MOTION_LEFT_FOOT)
+#define RIGHT_FOOT  MOTION_JOINT_BIT(MOTION_RIGHT_FOOT)
+
+// Neutral pose, then the first step to enter the gait
+static constexpr MotionKeyframe walkEnterKeyframes[] = {
+  //  LF   LL   RF   RL    mS   profile       joints
+  {{   0,   0,   0,   0}, 300, MINIMUM_JERK, MOTION_ALL_JOINTS},
+  {{  20,   0,  40,   0}, 180, MINIMUM_JERK, FEET},              // Move to first step pose
+  {{  20,  15,  20,  15}, 140, MINIMUM_JERK, RIGHT_FOOT | LEGS}, // Prepare for walking
+  {{   0,  15,   0,  15}, 180, MINIMUM_JERK, FEET},              // Return to neutral
+};
+
+// One full stride, repeated while walking
+static constexpr MotionKeyframe walkLoopKeyframes[] = {
+  //  LF   LL   RF   RL    mS   profile       joints
+  {{ -40,  15, -20,  15}, 180, MINIMUM_JERK, FEET},              // Move feet backward
+  {{ -20, -15, -20, -15}, 240, MINIMUM_JERK, LEFT_FOOT | LEGS},  // Shift weight and move legs
+  {{   0, -15,   0, -15}, 180, MINIMUM_JERK, FEET},              // Return to neutral
+  {{  20, -15,  40, -15}, 180, MINIMUM_JERK, FEET},              // Move feet forward
+  {{  20,  15,  20,  15}, 240, MINIMUM_JERK, RIGHT_FOOT | LEGS}, // Shift weight and move legs
+  {{   0,  15,   0,  15}, 180, MINIMUM_JERK, FEET},              // Return to neutral
+};
+
+// Back to a safe neutral pose
+static constexpr MotionKeyframe walkExitKeyframes[] = {
+  //  LF   LL   RF   RL    mS   profile       joints
+  {{ -40,  15, -20,  15}, 180, MINIMUM_JERK, FEET},              // Move feet backward to stop
+  {{ -20,   0, -20,   0}, 140, MINIMUM_JERK, LEFT_FOOT | LEGS},  // Return legs to neutral
+  {{   0,   0,   0,   0}, 180, MINIMUM_JERK, FEET},              // Set all joints to zero
+};
+
+static const MotionGait walkGait = {
+  {walkEnterKeyframes, sizeof(walkEnterKeyframes) / sizeof(MotionKeyframe)},
+  {walkLoopKeyframes, sizeof(walkLoopKeyframes) / sizeof(MotionKeyframe)},
+  {walkExitKeyframes, sizeof(walkExitKeyframes) / sizeof(MotionKeyframe)},
+};
+
+#undef FEET
+#undef LEGS
+#undef LEFT_FOOT
+#undef RIGHT_FOOT
+
+#endif